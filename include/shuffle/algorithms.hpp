@@ -0,0 +1,467 @@
+#ifndef SHUFFLE_ALGORITHMS_HPP
+#define SHUFFLE_ALGORITHMS_HPP
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "shuffle/phase.hpp"
+#include "shuffle/thread_pool.hpp"
+
+// Generic shuffling algorithms.
+//
+// Every algorithm shuffles the range [first, last) in place. The iterators must be
+// random-access and `rng` must satisfy UniformRandomBitGenerator. The merge variants
+// additionally accept a scratch iterator pointing at a buffer of at least
+// (last - first) elements; the overloads without it allocate one internally, which
+// requires a default-constructible value type.
+namespace shuffle {
+
+// Ranges shorter than this are shuffled directly by the merge variants.
+constexpr std::size_t kMergeThreshold = 32;
+
+// Ranges longer than this spawn an OpenMP task for their left half.
+constexpr std::size_t kParallelTaskThreshold = kMergeThreshold * 4;
+
+// Default cutoff of the work-stealing pool variant. Its tasks cost a heap-allocated
+// closure and a freshly seeded engine each, so they need more work to pay off.
+constexpr std::size_t kPoolTaskGrain = std::size_t(1) << 14;
+
+
+// Adapts std::rand() to the UniformRandomBitGenerator interface, so that the biased
+// algorithms can be fed the same low-quality source they are meant to demonstrate.
+struct StdRandEngine {
+    using result_type = unsigned int;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return static_cast<result_type>(RAND_MAX); }
+
+    result_type operator()() { return static_cast<result_type>(std::rand()); }
+};
+
+// A rand()-style engine with its own state, standing in for std::rand() where several
+// threads must not share one generator. Like glibc's rand_r(), it concatenates the high
+// bits of three steps of the C standard's sample linear congruential generator, so its
+// range matches glibc's RAND_MAX of 2^31 - 1.
+class RandLcgEngine {
+    public:
+        using result_type = unsigned int;
+
+        explicit RandLcgEngine(result_type seed = 1) : m_next(seed) {}
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0x7fffffffu; }
+
+        void seed(result_type seed) { m_next = seed; }
+
+        result_type operator()() {
+            result_type result = step() % 2048u;
+            result = (result << 10) ^ (step() % 1024u);
+            result = (result << 10) ^ (step() % 1024u);
+            return result;
+        }
+
+    private:
+        // Advances the generator and returns its upper 16 bits.
+        result_type step() {
+            m_next = m_next * 1103515245u + 12345u;
+            return static_cast<result_type>(m_next / 65536u);
+        }
+
+    private:
+        std::uint32_t m_next;
+};
+
+
+namespace detail {
+
+// Draws an index uniformly from [lo, hi].
+template <typename URBG>
+std::size_t uniformIndex(URBG& rng, std::size_t lo, std::size_t hi) {
+    std::uniform_int_distribution<std::size_t> dis(lo, hi);
+    return dis(rng);
+}
+
+// Draws a raw value reduced with the modulo operator, keeping its bias on purpose.
+template <typename URBG>
+std::size_t moduloIndex(URBG& rng, std::size_t bound) {
+    return static_cast<std::size_t>(rng() - (URBG::min)()) % bound;
+}
+
+// Forward Durstenfeld shuffle of arr[start, end), used as the merge base case.
+template <typename RandomIt, typename URBG>
+void shuffleBlock(RandomIt arr, std::size_t start, std::size_t end, URBG& rng) {
+    for (std::size_t i = start; i < end; i++) {
+        // Choose a random index in the range [i, end - 1]
+        std::size_t randomIndex = uniformIndex(rng, i, end - 1);
+        std::iter_swap(arr + i, arr + randomIndex);
+    }
+}
+
+// Interleaves the shuffled halves arr[start, mid) and arr[mid, end) uniformly at
+// random into temp[start, end).
+template <typename RandomIt, typename ScratchIt, typename URBG>
+void interleaveHalves(
+    RandomIt arr,
+    ScratchIt temp,
+    std::size_t start,
+    std::size_t mid,
+    std::size_t end,
+    URBG& rng
+) {
+    std::size_t left = start;
+    std::size_t right = mid;
+    std::size_t idx = start;  // temp index starts at 'start'.
+
+    while (left < mid && right < end) {
+        std::size_t leftCount = mid - left;
+        std::size_t rightCount = end - right;
+        std::size_t pick = uniformIndex(rng, 0, leftCount + rightCount - 1);
+
+        if (pick < leftCount) {
+            temp[idx++] = std::move(arr[left++]);
+        } else {
+            temp[idx++] = std::move(arr[right++]);
+        }
+    }
+
+    // Append any remaining elements from the left or right half.
+    while (left < mid) {
+        temp[idx++] = std::move(arr[left++]);
+    }
+
+    while (right < end) {
+        temp[idx++] = std::move(arr[right++]);
+    }
+}
+
+// Merges the shuffled halves arr[start, mid) and arr[mid, end) via a uniformly random
+// interleaving, using temp[start, end) as the staging area.
+template <typename RandomIt, typename ScratchIt, typename URBG>
+void randomMerge(
+    RandomIt arr,
+    ScratchIt temp,
+    std::size_t start,
+    std::size_t mid,
+    std::size_t end,
+    URBG& rng
+) {
+    bool announce = end - start >= kPhaseGranularity;
+    {
+        PhaseScope mergeScope(Phase::Merge, announce);
+        interleaveHalves(arr, temp, start, mid, end, rng);
+    }
+
+    PhaseScope copyBackScope(Phase::CopyBack, announce);
+    std::move(temp + start, temp + end, arr + start);
+}
+
+template <typename RandomIt, typename ScratchIt, typename URBG>
+void mergeShuffleRec(RandomIt arr, ScratchIt temp, std::size_t start, std::size_t end, URBG& rng) {
+    std::size_t n = end - start;
+    if (n <= 1) {
+        return;
+    }
+
+    if (n < kMergeThreshold) {
+        shuffleBlock(arr, start, end, rng);
+        return;
+    }
+
+    // Recursively split the range into two halves and shuffle each half.
+    std::size_t mid = start + n / 2;
+    mergeShuffleRec(arr, temp, start, mid, rng);
+    mergeShuffleRec(arr, temp, mid, end, rng);
+    randomMerge(arr, temp, start, mid, end, rng);
+}
+
+// An engine padded to its own cache line so that per-thread engines do not false-share.
+template <typename URBG>
+struct alignas(64) PaddedEngine {
+    URBG engine;
+};
+
+// Returns one engine per thread, each seeded from `rng` through a std::seed_seq.
+template <typename URBG>
+std::vector<PaddedEngine<URBG>> seedEngines(URBG& rng, int threads) {
+    std::vector<PaddedEngine<URBG>> engines;
+    engines.reserve(static_cast<std::size_t>(threads));
+    for (int t = 0; t < threads; t++) {
+        std::seed_seq seeds{rng(), rng(), rng(), rng()};
+        engines.push_back({URBG(seeds)});
+    }
+    return engines;
+}
+
+template <typename RandomIt, typename ScratchIt, typename URBG>
+void parallelMergeShuffleRec(
+    RandomIt arr,
+    ScratchIt temp,
+    std::size_t start,
+    std::size_t end,
+    std::vector<PaddedEngine<URBG>>* engines,
+    std::size_t grain
+) {
+    std::size_t n = end - start;
+    if (n <= 1) {
+        return;
+    }
+
+    if (n < kMergeThreshold) {
+        shuffleBlock(arr, start, end, (*engines)[omp_get_thread_num()].engine);
+        return;
+    }
+
+    std::size_t mid = start + n / 2;
+
+    // Spawn a task for the left half only if the subproblem is large enough.
+    #pragma omp task if(n > grain)
+    {
+        parallelMergeShuffleRec(arr, temp, start, mid, engines, grain);
+    }
+
+    parallelMergeShuffleRec(arr, temp, mid, end, engines, grain);
+    #pragma omp taskwait
+
+    randomMerge(arr, temp, start, mid, end, (*engines)[omp_get_thread_num()].engine);
+}
+
+// Pool variant: a stolen task may run on any thread, including one that is waiting on
+// an unrelated shuffle, so engines belong to tasks rather than threads. The left half
+// gets an engine seeded from `rng`; the right half keeps drawing from `rng`. Waiting
+// threads run tasks nested on their own stack, so the left engine, which is several KiB
+// for std::mt19937, lives on the heap rather than in the recursion frame.
+template <typename RandomIt, typename ScratchIt, typename URBG>
+void poolMergeShuffleRec(
+    RandomIt arr,
+    ScratchIt temp,
+    std::size_t start,
+    std::size_t end,
+    URBG& rng,
+    WorkStealingPool& pool,
+    std::size_t grain
+) {
+    std::size_t n = end - start;
+    if (n <= grain) {
+        mergeShuffleRec(arr, temp, start, end, rng);
+        return;
+    }
+
+    std::size_t mid = start + n / 2;
+    std::unique_ptr<URBG> leftEngine;
+    {
+        std::seed_seq seeds{rng(), rng(), rng(), rng()};
+        leftEngine = std::make_unique<URBG>(seeds);
+    }
+
+    TaskGroup group(pool);
+    group.run([&] {
+        poolMergeShuffleRec(arr, temp, start, mid, *leftEngine, pool, grain);
+    });
+    poolMergeShuffleRec(arr, temp, mid, end, rng, pool, grain);
+    group.wait();
+
+    randomMerge(arr, temp, start, mid, end, rng);
+}
+
+} // namespace detail
+
+
+/**
+ * @brief Naive shuffle that swaps every element with one drawn from the whole range
+ * using the modulo operator. Biased; kept for comparison.
+ */
+template <typename RandomIt, typename URBG>
+void biasedNaiveShuffle(RandomIt first, RandomIt last, URBG& rng) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    for (std::size_t i = 0; i < length; i++) {
+        std::iter_swap(first + i, first + detail::moduloIndex(rng, length));
+    }
+}
+
+/**
+ * @brief Naive shuffle that swaps every element with one drawn uniformly from the
+ * whole range. Still biased, because n^n swap sequences cannot map evenly onto n!
+ * permutations.
+ */
+template <typename RandomIt, typename URBG>
+void naiveShuffle(RandomIt first, RandomIt last, URBG& rng) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    for (std::size_t i = 0; i < length; i++) {
+        std::iter_swap(first + i, first + detail::uniformIndex(rng, 0, length - 1));
+    }
+}
+
+/**
+ * @brief Original Fisher–Yates "strike out" method with modulo-reduced picks.
+ *
+ * The picked element is rotated to the front of the remaining range, which keeps the
+ * order of the remaining elements exactly as erasing it from a list would. O(n^2).
+ */
+template <typename RandomIt, typename URBG>
+void biasedFisherYatesShuffle(RandomIt first, RandomIt last, URBG& rng) {
+    for (RandomIt it = first; it != last; ++it) {
+        std::size_t remaining = static_cast<std::size_t>(std::distance(it, last));
+        RandomIt pick = it + detail::moduloIndex(rng, remaining);
+        std::rotate(it, pick, std::next(pick));
+    }
+}
+
+/**
+ * @brief Original Fisher–Yates "strike out" method with uniform picks. O(n^2).
+ */
+template <typename RandomIt, typename URBG>
+void fisherYatesShuffle(RandomIt first, RandomIt last, URBG& rng) {
+    for (RandomIt it = first; it != last; ++it) {
+        std::size_t remaining = static_cast<std::size_t>(std::distance(it, last));
+        RandomIt pick = it + detail::uniformIndex(rng, 0, remaining - 1);
+        std::rotate(it, pick, std::next(pick));
+    }
+}
+
+/**
+ * @brief Durstenfeld shuffle with modulo-reduced picks. Biased; kept for comparison.
+ */
+template <typename RandomIt, typename URBG>
+void biasedDurstenfeldShuffle(RandomIt first, RandomIt last, URBG& rng) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    if (length < 2) {
+        return;
+    }
+
+    for (std::size_t i = length - 1; i > 0; --i) {
+        std::iter_swap(first + i, first + detail::moduloIndex(rng, i + 1));
+    }
+}
+
+/**
+ * @brief Unbiased Durstenfeld shuffle: iterates backwards and swaps each element with
+ * one drawn uniformly from the unshuffled prefix [0, i].
+ */
+template <typename RandomIt, typename URBG>
+void durstenfeldShuffle(RandomIt first, RandomIt last, URBG& rng) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    if (length < 2) {
+        return;
+    }
+
+    for (std::size_t i = length - 1; i > 0; --i) {
+        std::iter_swap(first + i, first + detail::uniformIndex(rng, 0, i));
+    }
+}
+
+/**
+ * @brief Sort-based shuffle: pairs every element with a random 32-bit key and stable
+ * sorts by key. O(n log n); elements are moved into and out of the key buffer.
+ */
+template <typename RandomIt, typename URBG>
+void randomShuffle(RandomIt first, RandomIt last, URBG& rng) {
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+    using KeyedValue = std::pair<unsigned int, ValueType>;
+
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    std::uniform_int_distribution<unsigned int> dis(0, std::numeric_limits<unsigned int>::max());
+
+    std::vector<KeyedValue> paired;
+    paired.reserve(length);
+    for (RandomIt it = first; it != last; ++it) {
+        paired.emplace_back(dis(rng), std::move(*it));
+    }
+
+    // Use a stable sort to preserve the random ordering of equal keys.
+    std::stable_sort(paired.begin(), paired.end(),
+        [](const KeyedValue& a, const KeyedValue& b) {
+            return a.first < b.first;
+        }
+    );
+
+    for (std::size_t i = 0; i < length; ++i) {
+        first[i] = std::move(paired[i].second);
+    }
+}
+
+/**
+ * @brief Merge shuffle: recursively shuffles both halves and merges them via a
+ * uniformly random interleaving, staging merges in [scratch, scratch + n).
+ */
+template <typename RandomIt, typename ScratchIt, typename URBG>
+void mergeShuffle(RandomIt first, RandomIt last, ScratchIt scratch, URBG& rng) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    detail::mergeShuffleRec(first, scratch, 0, length, rng);
+}
+
+template <typename RandomIt, typename URBG>
+void mergeShuffle(RandomIt first, RandomIt last, URBG& rng) {
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+    std::vector<ValueType> temp(static_cast<std::size_t>(std::distance(first, last)));
+    mergeShuffle(first, last, temp.begin(), rng);
+}
+
+/**
+ * @brief Merge shuffle parallelised with OpenMP tasks.
+ *
+ * Each OpenMP thread draws from its own engine of type URBG, seeded from `rng` through
+ * a std::seed_seq, so `rng` itself is only touched by the calling thread. Subranges of
+ * at most `grain` elements are not split into further tasks.
+ */
+template <typename RandomIt, typename ScratchIt, typename URBG>
+void parallelMergeShuffle(
+    RandomIt first,
+    RandomIt last,
+    ScratchIt scratch,
+    URBG& rng,
+    std::size_t grain = kParallelTaskThreshold
+) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+
+    std::vector<detail::PaddedEngine<URBG>> engines = detail::seedEngines(rng, omp_get_max_threads());
+
+    #pragma omp parallel
+    {
+        #pragma omp single nowait
+        {
+            detail::parallelMergeShuffleRec(first, scratch, 0, length, &engines, grain);
+        }
+    }
+}
+
+/**
+ * @brief Merge shuffle parallelised on a WorkStealingPool.
+ *
+ * The calling thread takes part in the work, and the call may be made from inside a
+ * pool task. Every task owns an engine of type URBG seeded from its parent's, so for a
+ * given `grain` the result depends only on the state of `rng`, not on the pool size or
+ * on how tasks were scheduled.
+ */
+template <typename RandomIt, typename ScratchIt, typename URBG>
+void parallelMergeShuffle(
+    RandomIt first,
+    RandomIt last,
+    ScratchIt scratch,
+    URBG& rng,
+    WorkStealingPool& pool,
+    std::size_t grain = kPoolTaskGrain
+) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    detail::poolMergeShuffleRec(first, scratch, 0, length, rng, pool, std::max(grain, kMergeThreshold));
+}
+
+template <typename RandomIt, typename URBG>
+void parallelMergeShuffle(RandomIt first, RandomIt last, URBG& rng) {
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+    std::vector<ValueType> temp(static_cast<std::size_t>(std::distance(first, last)));
+    parallelMergeShuffle(first, last, temp.begin(), rng);
+}
+
+} // namespace shuffle
+
+#endif // SHUFFLE_ALGORITHMS_HPP
@@ -0,0 +1,115 @@
+#ifndef SHUFFLE_ALLOCATOR_HPP
+#define SHUFFLE_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace shuffle {
+
+// Buffers are aligned to a cache line.
+constexpr std::size_t kBufferAlignment = 64;
+
+// Buffers of at least this size are mapped directly, and backed by huge pages, while huge
+// pages are enabled. Mappings are aligned to it, the transparent huge page size on x86-64;
+// explicit hugetlbfs pages use the system's default size from /proc/meminfo instead.
+constexpr std::size_t kHugePageSize = std::size_t(2) << 20;
+
+// Counters of the buffers mapped while huge pages were enabled.
+struct HugePageStats {
+    std::uint64_t hugetlbAllocations = 0;   // Backed by explicit hugetlbfs pages.
+    std::uint64_t hugetlbBytes = 0;
+    std::uint64_t madvisedAllocations = 0;  // Fell back to transparent huge pages.
+    std::uint64_t madvisedBytes = 0;
+};
+
+// Counters of the buffers mapped with mmap, while huge pages were enabled, instead of being
+// obtained from operator new.
+struct MappedBufferStats {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;         // Mapped length, rounded up to a whole huge page.
+};
+
+// Enables or disables huge pages for buffers of at least kHugePageSize bytes allocated
+// from now on. Explicit hugetlbfs pages are tried first for buffers of at least one such
+// page; if the pool is empty the buffer is mapped normally and advised with MADV_HUGEPAGE.
+// Off by default.
+void setHugePagesEnabled(bool enabled);
+bool hugePagesEnabled();
+
+// Returns the counters accumulated since the start of the process.
+HugePageStats hugePageStats();
+MappedBufferStats mappedBufferStats();
+
+// Returns the size in bytes of the level 2 or level 3 cache as reported by the C library,
+// or 0 if it is unknown. Each level is looked up once and cached for the process.
+std::size_t detectedCacheBytes(unsigned int level);
+
+// Returns how many bytes of [data, data + bytes) are currently backed by huge pages,
+// either transparent or hugetlbfs, according to /proc/self/smaps.
+std::size_t hugePageBackedBytes(const void* data, std::size_t bytes);
+
+namespace detail {
+
+void* allocateBuffer(std::size_t bytes);
+void deallocateBuffer(void* pointer, std::size_t bytes) noexcept;
+
+} // namespace detail
+
+
+/**
+ * @brief Allocator for permutation and scratch buffers.
+ *
+ * Elements created without arguments are default-initialised rather than
+ * value-initialised, so `std::vector<unsigned int, BufferAllocator<unsigned int>> v(n)`
+ * does not zero its memory. Untouched pages are then first written by whichever thread
+ * fills them, which is what places them on that thread's NUMA node.
+ *
+ * Memory is cache-line aligned and comes from operator new. While huge pages are enabled,
+ * buffers of at least kHugePageSize bytes are instead mapped with mmap at a huge-page
+ * boundary and backed by huge pages, which removes most page walks from the random
+ * accesses of large shuffles.
+ */
+template <typename T>
+struct BufferAllocator {
+    using value_type = T;
+
+    BufferAllocator() noexcept = default;
+
+    template <typename U>
+    BufferAllocator(const BufferAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t count) {
+        return static_cast<T*>(detail::allocateBuffer(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t count) noexcept {
+        detail::deallocateBuffer(pointer, count * sizeof(T));
+    }
+
+    template <typename U>
+    void construct(U* pointer) noexcept(std::is_nothrow_default_constructible<U>::value) {
+        ::new (static_cast<void*>(pointer)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* pointer, Args&&... args) {
+        ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const BufferAllocator<T>&, const BufferAllocator<U>&) noexcept {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const BufferAllocator<T>&, const BufferAllocator<U>&) noexcept {
+    return false;
+}
+
+} // namespace shuffle
+
+#endif // SHUFFLE_ALLOCATOR_HPP
@@ -0,0 +1,141 @@
+#ifndef SHUFFLE_INSIDE_OUT_HPP
+#define SHUFFLE_INSIDE_OUT_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "shuffle/algorithms.hpp"
+#include "shuffle/phase.hpp"
+
+// Fused initialise-and-shuffle ("inside-out") algorithms.
+//
+// Instead of filling a range and then shuffling it, these algorithms write a random
+// permutation of value(0), ..., value(n - 1) into [first, last), which is never read
+// before it is written. Its previous contents do not matter, so the range can be freshly
+// allocated, uninitialised memory.
+namespace shuffle {
+
+// Outputs of at least this many bytes are written with non-temporal stores by the final
+// merge of insideOutMergeShuffle, as they would only evict the scratch buffer from the
+// cache before being read back.
+constexpr std::size_t kNonTemporalMinBytes = std::size_t(64) << 20;
+
+
+namespace detail {
+
+// Writes a random permutation of value(start), ..., value(end - 1) into dst[start, end)
+// with the inside-out Fisher–Yates shuffle: value(i) lands in a uniformly drawn slot
+// j <= i, whose previous occupant moves up to slot i.
+template <typename RandomIt, typename URBG, typename Generator>
+void insideOutBlock(RandomIt dst, std::size_t start, std::size_t end, URBG& rng, Generator& value) {
+    for (std::size_t i = start; i < end; i++) {
+        std::size_t j = uniformIndex(rng, start, i);
+        if (j != i) {
+            dst[i] = std::move(dst[j]);
+        }
+        dst[j] = value(i);
+    }
+}
+
+// Leaves a random permutation of value(start), ..., value(end - 1) in dst[start, end),
+// using other[start, end) as scratch. The halves are built in `other` and interleaved
+// straight into `dst`, so the buffers swap roles at every level and nothing is copied back.
+template <typename DstIt, typename OtherIt, typename URBG, typename Generator>
+void insideOutMergeRec(
+    DstIt dst,
+    OtherIt other,
+    std::size_t start,
+    std::size_t end,
+    URBG& rng,
+    Generator& value
+) {
+    std::size_t n = end - start;
+    if (n < kMergeThreshold) {
+        insideOutBlock(dst, start, end, rng, value);
+        return;
+    }
+
+    std::size_t mid = start + n / 2;
+    insideOutMergeRec(other, dst, start, mid, rng, value);
+    insideOutMergeRec(other, dst, mid, end, rng, value);
+
+    PhaseScope mergeScope(Phase::Merge, n >= kPhaseGranularity);
+    interleaveHalves(other, dst, start, mid, end, rng);
+}
+
+#if defined(__SSE2__)
+// Whether elements of type T can be written with _mm_stream_si32.
+template <typename T>
+constexpr bool kStreamable = std::is_integral<T>::value && sizeof(T) == sizeof(int);
+
+// Destination of interleaveHalves whose element assignments bypass the cache.
+template <typename T>
+struct NonTemporalWriter {
+    struct Slot {
+        T* address;
+
+        Slot& operator=(T value) {
+            _mm_stream_si32(reinterpret_cast<int*>(address), static_cast<int>(value));
+            return *this;
+        }
+    };
+
+    T* data;
+
+    Slot operator[](std::size_t i) const { return Slot{data + i}; }
+};
+#endif
+
+} // namespace detail
+
+
+/**
+ * @brief Inside-out Fisher–Yates shuffle: writes a uniformly random permutation of
+ * value(0), ..., value(n - 1) into [first, last) in a single pass.
+ */
+template <typename RandomIt, typename URBG, typename Generator>
+void insideOutShuffle(RandomIt first, RandomIt last, URBG& rng, Generator value) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    detail::insideOutBlock(first, 0, length, rng, value);
+}
+
+/**
+ * @brief Merge shuffle whose base cases generate their values with insideOutShuffle,
+ * writing a uniformly random permutation of value(0), ..., value(n - 1) into
+ * [first, last) with [scratch, scratch + n) as the other half of a ping-pong pair.
+ *
+ * When `first` is a pointer to 32-bit integers and the output is at least
+ * kNonTemporalMinBytes, the final merge writes it with non-temporal stores.
+ */
+template <typename RandomIt, typename ScratchIt, typename URBG, typename Generator>
+void insideOutMergeShuffle(RandomIt first, RandomIt last, ScratchIt scratch, URBG& rng, Generator value) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+
+#if defined(__SSE2__)
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+    if constexpr (std::is_pointer<RandomIt>::value && detail::kStreamable<ValueType>) {
+        if (length * sizeof(ValueType) >= kNonTemporalMinBytes) {
+            std::size_t mid = length / 2;
+            detail::insideOutMergeRec(scratch, first, 0, mid, rng, value);
+            detail::insideOutMergeRec(scratch, first, mid, length, rng, value);
+
+            PhaseScope mergeScope(Phase::Merge);
+            detail::interleaveHalves(scratch, detail::NonTemporalWriter<ValueType>{first}, 0, mid, length, rng);
+            _mm_sfence();
+            return;
+        }
+    }
+#endif
+
+    detail::insideOutMergeRec(first, scratch, 0, length, rng, value);
+}
+
+} // namespace shuffle
+
+#endif // SHUFFLE_INSIDE_OUT_HPP
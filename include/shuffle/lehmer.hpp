@@ -0,0 +1,115 @@
+#ifndef SHUFFLE_LEHMER_HPP
+#define SHUFFLE_LEHMER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <utility>
+
+#include "shuffle/algorithms.hpp"
+
+// Single-draw shuffles of short ranges.
+//
+// For n <= 20, n! fits in 64 bits, so one uniform draw from [0, n!) selects the whole
+// permutation. Read as a mixed-radix number with digits d_i in [0, i], the draw is
+// decoded into exactly the swap sequence a Durstenfeld shuffle would have made, with
+// one bounded draw instead of n - 1. A 64-bit engine serves that draw with one call. A
+// 32-bit engine such as std::mt19937 needs one call for n <= 12, where n! < 2^32, and at
+// least two beyond that.
+namespace shuffle {
+
+// Longest range whose permutations can be numbered with a 64-bit integer.
+constexpr std::size_t kLehmerMaxLength = 20;
+
+
+namespace detail {
+
+constexpr std::array<std::uint64_t, kLehmerMaxLength + 1> makeFactorials() {
+    std::array<std::uint64_t, kLehmerMaxLength + 1> factorials{};
+    factorials[0] = 1;
+    for (std::size_t i = 1; i <= kLehmerMaxLength; i++) {
+        factorials[i] = factorials[i - 1] * i;
+    }
+    return factorials;
+}
+
+// kFactorials[n] == n!
+constexpr std::array<std::uint64_t, kLehmerMaxLength + 1> kFactorials = makeFactorials();
+
+// Peels the digit for position I off `code` and swaps it into place. The divisor is a
+// compile-time constant, so the division becomes a multiplication.
+template <std::size_t I, typename RandomIt>
+inline void decodeLehmerDigit(RandomIt first, std::uint64_t& code) {
+    std::size_t digit = static_cast<std::size_t>(code % (I + 1));
+    code /= I + 1;
+    std::iter_swap(first + I, first + digit);
+}
+
+// Applies the digits for positions N - 1 down to 1, fully unrolled.
+template <std::size_t N, typename RandomIt, std::size_t... K>
+inline void decodeLehmer(RandomIt first, std::uint64_t code, std::index_sequence<K...>) {
+    (decodeLehmerDigit<N - 1 - K>(first, code), ...);
+}
+
+template <std::size_t N, typename RandomIt>
+void decodeLehmerCode(RandomIt first, std::uint64_t code) {
+    if constexpr (N >= 2) {
+        decodeLehmer<N>(first, code, std::make_index_sequence<N - 1>{});
+    } else {
+        (void)first;
+        (void)code;
+    }
+}
+
+// One decoder per length 0..kLehmerMaxLength, indexed by the runtime length.
+template <typename RandomIt, std::size_t... N>
+constexpr std::array<void (*)(RandomIt, std::uint64_t), sizeof...(N)> makeLehmerDecoders(std::index_sequence<N...>) {
+    return {{&decodeLehmerCode<N, RandomIt>...}};
+}
+
+} // namespace detail
+
+
+/**
+ * @brief Unbiased shuffle of the N elements starting at `first` from a single uniform
+ * draw in [0, N!), decoded with fully unrolled code specialised for N.
+ */
+template <std::size_t N, typename RandomIt, typename URBG>
+void lehmerShuffle(RandomIt first, URBG& rng) {
+    static_assert(N <= kLehmerMaxLength, "N! must fit in 64 bits");
+    if constexpr (N >= 2) {
+        std::uniform_int_distribution<std::uint64_t> dis(0, detail::kFactorials[N] - 1);
+        detail::decodeLehmerCode<N>(first, dis(rng));
+    } else {
+        (void)first;
+        (void)rng;
+    }
+}
+
+/**
+ * @brief Unbiased shuffle that dispatches to lehmerShuffle<N> for ranges of up to
+ * kLehmerMaxLength elements and to durstenfeldShuffle for longer ones.
+ */
+template <typename RandomIt, typename URBG>
+void lehmerShuffle(RandomIt first, RandomIt last, URBG& rng) {
+    static constexpr std::array<void (*)(RandomIt, std::uint64_t), kLehmerMaxLength + 1> decoders =
+        detail::makeLehmerDecoders<RandomIt>(std::make_index_sequence<kLehmerMaxLength + 1>{});
+
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    if (length > kLehmerMaxLength) {
+        durstenfeldShuffle(first, last, rng);
+        return;
+    }
+    if (length < 2) {
+        return;
+    }
+
+    std::uniform_int_distribution<std::uint64_t> dis(0, detail::kFactorials[length] - 1);
+    decoders[length](first, dis(rng));
+}
+
+} // namespace shuffle
+
+#endif // SHUFFLE_LEHMER_HPP
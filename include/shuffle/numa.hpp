@@ -0,0 +1,146 @@
+#ifndef SHUFFLE_NUMA_HPP
+#define SHUFFLE_NUMA_HPP
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "shuffle/algorithms.hpp"
+
+// NUMA-aware parallel shuffling.
+//
+// The range is split into one contiguous chunk per OpenMP thread, and chunk t is pinned
+// to the t-th CPU of an order that takes the nodes round-robin, so that chunks are spread
+// over every node even when there are fewer threads than CPUs. numaFirstTouch() writes
+// every chunk from its owning thread, which makes the kernel place its pages on that
+// thread's node; numaParallelMergeShuffle() then shuffles each chunk on the same thread
+// and merges neighbouring chunks pairwise, each merge running on the node of its left
+// run. On single-node machines threads are not pinned and the algorithms behave like a
+// plain partitioned merge shuffle.
+namespace shuffle {
+
+struct NumaTopology {
+    std::vector<int> nodeIds;                 // Kernel ids of the nodes with usable CPUs.
+    std::vector<std::vector<int>> nodeCpus;   // Usable CPUs of every node in nodeIds.
+    std::vector<int> cpuNodes;                // Kernel node id of every CPU in cpuOrder.
+    std::vector<int> cpuOrder;                // Usable CPUs, taking the nodes round-robin.
+
+    int nodeCount() const { return static_cast<int>(nodeCpus.size()); }
+};
+
+// Local/remote split of a buffer's pages relative to the thread owning each chunk.
+struct NumaPlacement {
+    int nodes = 1;
+    std::uint64_t localPages = 0;
+    std::uint64_t remotePages = 0;
+    std::uint64_t unknownPages = 0;   // Not yet faulted in, or not queryable.
+    std::uint64_t sampledPages = 0;
+    std::uint64_t totalPages = 0;
+};
+
+// Returns the topology of the CPUs this process may run on, detected once from sysfs.
+// Falls back to a single node holding every usable CPU.
+const NumaTopology& numaTopology();
+
+// Returns the kernel id of the node that chunk `chunk` of the partitioned algorithms is placed on.
+int numaChunkNode(int chunk);
+
+// Half-open element range [first, second) of chunk `chunk` out of `chunks` equal chunks.
+inline std::pair<std::size_t, std::size_t> chunkBounds(std::size_t length, int chunks, int chunk) {
+    std::size_t begin = length * static_cast<std::size_t>(chunk) / static_cast<std::size_t>(chunks);
+    std::size_t end = length * static_cast<std::size_t>(chunk + 1) / static_cast<std::size_t>(chunks);
+    return std::make_pair(begin, end);
+}
+
+/**
+ * @brief Queries which node holds the pages of `length` elements of `elementSize` bytes
+ * at `data`, and counts them as local or remote to the chunk owner under a split into
+ * `chunks` chunks. At most 65536 evenly spaced pages are sampled.
+ */
+NumaPlacement measureNumaPlacement(const void* data, std::size_t elementSize, std::size_t length, int chunks);
+
+// Pins the calling thread to the CPU that owns chunk `chunk` for the lifetime of the
+// scope, on multi-node machines only, and restores its previous affinity afterwards.
+class NumaThreadPin {
+    public:
+        explicit NumaThreadPin(int chunk);
+        ~NumaThreadPin();
+
+        NumaThreadPin(const NumaThreadPin&) = delete;
+        NumaThreadPin& operator=(const NumaThreadPin&) = delete;
+
+    private:
+        bool m_pinned;
+        std::vector<unsigned char> m_previousMask;
+};
+
+
+/**
+ * @brief Fills data[i] = fill(i) and touches scratch[i], each chunk on its owning thread.
+ */
+template <typename T, typename Fill>
+void numaFirstTouch(T* data, T* scratch, std::size_t length, Fill fill) {
+    int chunks = omp_get_max_threads();
+
+    #pragma omp parallel num_threads(chunks)
+    {
+        int team = omp_get_num_threads();
+        for (int chunk = omp_get_thread_num(); chunk < chunks; chunk += team) {
+            NumaThreadPin pin(chunk);
+            std::pair<std::size_t, std::size_t> bounds = chunkBounds(length, chunks, chunk);
+            for (std::size_t i = bounds.first; i < bounds.second; i++) {
+                data[i] = fill(i);
+                scratch[i] = T();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Partitioned parallel merge shuffle that keeps every chunk on its owner thread.
+ *
+ * Each chunk is Durstenfeld-shuffled by its owner, then neighbouring runs of chunks are
+ * merged pairwise via uniformly random interleavings, level by level, by the owner of
+ * the left run. The chunking matches numaFirstTouch().
+ */
+template <typename RandomIt, typename ScratchIt, typename URBG>
+void numaParallelMergeShuffle(RandomIt first, RandomIt last, ScratchIt scratch, URBG& rng) {
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    int chunks = omp_get_max_threads();
+    std::vector<detail::PaddedEngine<URBG>> engines = detail::seedEngines(rng, chunks);
+
+    #pragma omp parallel num_threads(chunks)
+    {
+        int team = omp_get_num_threads();
+        int thread = omp_get_thread_num();
+
+        for (int chunk = thread; chunk < chunks; chunk += team) {
+            NumaThreadPin pin(chunk);
+            std::pair<std::size_t, std::size_t> bounds = chunkBounds(length, chunks, chunk);
+            durstenfeldShuffle(first + bounds.first, first + bounds.second, engines[chunk].engine);
+        }
+
+        for (int width = 1; width < chunks; width *= 2) {
+            #pragma omp barrier
+            for (int chunk = thread; chunk < chunks; chunk += team) {
+                if (chunk % (2 * width) != 0 || chunk + width >= chunks) {
+                    continue;
+                }
+                NumaThreadPin pin(chunk);
+                std::size_t start = chunkBounds(length, chunks, chunk).first;
+                std::size_t mid = chunkBounds(length, chunks, chunk + width).first;
+                std::size_t end = chunkBounds(length, chunks, std::min(chunk + 2 * width, chunks) - 1).second;
+                detail::randomMerge(first, scratch, start, mid, end, engines[chunk].engine);
+            }
+        }
+    }
+}
+
+} // namespace shuffle
+
+#endif // SHUFFLE_NUMA_HPP
@@ -0,0 +1,243 @@
+#ifndef SHUFFLE_PERMUTATION_HPP
+#define SHUFFLE_PERMUTATION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "shuffle/algorithms.hpp"
+#include "shuffle/allocator.hpp"
+
+// Indirect shuffling of large records.
+//
+// Swapping 64–256 byte records at random moves a lot of data and thrashes the cache.
+// IndirectShuffler instead shuffles a compact index array with one of the regular
+// algorithms and then applies that permutation to the records, either by gathering
+// them into a separate buffer or by following the permutation's cycles in place.
+namespace shuffle {
+
+enum class PermutationStrategy {
+    Auto,         // Pick one of the strategies below from the record size and length.
+    Direct,       // Shuffle the records themselves.
+    Gather,       // Gather records into a separate buffer in blocks, then move them back.
+    CycleFollow   // Apply the permutation in place, marking visited slots in a bitset.
+};
+
+// Records up to this size (two cache lines) are cheaper to swap directly than to move
+// through an index.
+constexpr std::size_t kDirectSwapMaxRecordBytes = 128;
+
+// Last-level cache size assumed when the C library cannot report one.
+constexpr std::size_t kCacheResidentBytes = std::size_t(32) << 20;
+
+// Number of records whose sources are prefetched together during a gather.
+constexpr std::size_t kGatherBlock = 64;
+
+// Returns the size of the last-level cache in bytes: the L3 cache, else the L2 cache for
+// machines without one, else kCacheResidentBytes. Record arrays up to this size are
+// assumed to stay in the cache, where the dependent loads of cycle following are cheap
+// and the gather buffer only adds footprint.
+inline std::size_t detectedLastLevelCacheBytes() {
+    for (unsigned int level : {3u, 2u}) {
+        std::size_t bytes = detectedCacheBytes(level);
+        if (bytes > 0) {
+            return bytes;
+        }
+    }
+    return kCacheResidentBytes;
+}
+
+
+/**
+ * @brief Chooses how a permutation should be applied to `length` records of
+ * `recordBytes` bytes each.
+ */
+inline PermutationStrategy choosePermutationStrategy(std::size_t recordBytes, std::size_t length) {
+    if (recordBytes <= kDirectSwapMaxRecordBytes) {
+        return PermutationStrategy::Direct;
+    }
+    if (recordBytes * length <= detectedLastLevelCacheBytes()) {
+        return PermutationStrategy::CycleFollow;
+    }
+    return PermutationStrategy::Gather;
+}
+
+
+namespace detail {
+
+// Hints the cache to fetch every line of the object at `address`.
+template <typename T>
+inline void prefetchObject(const T* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    const char* bytes = reinterpret_cast<const char*>(address);
+    for (std::size_t offset = 0; offset < sizeof(T); offset += 64) {
+        __builtin_prefetch(bytes + offset);
+    }
+#else
+    (void)address;
+#endif
+}
+
+} // namespace detail
+
+
+/**
+ * @brief Moves the records into `out` so that out[i] = first[perm[i]].
+ *
+ * The permutation is processed in blocks of kGatherBlock indices: the sources of a
+ * whole block are prefetched before any of them is moved, so the random reads overlap
+ * instead of stalling one at a time, while the writes stay sequential.
+ */
+template <typename RandomIt, typename IndexIt, typename OutputIt>
+void gatherPermutation(RandomIt first, IndexIt perm, std::size_t length, OutputIt out) {
+    for (std::size_t block = 0; block < length; block += kGatherBlock) {
+        std::size_t blockEnd = std::min(block + kGatherBlock, length);
+        for (std::size_t i = block; i < blockEnd; i++) {
+            detail::prefetchObject(&first[perm[i]]);
+        }
+        for (std::size_t i = block; i < blockEnd; i++) {
+            *out++ = std::move(first[perm[i]]);
+        }
+    }
+}
+
+/**
+ * @brief Rearranges the records in place so that the new first[i] is the old
+ * first[perm[i]].
+ *
+ * Each cycle of the permutation is followed once, holding a single record aside, so
+ * every record is moved exactly once. Visited slots are tracked in a bitset of
+ * length / 8 bytes instead of by mutating `perm`.
+ */
+template <typename RandomIt, typename IndexIt>
+void applyPermutationInPlace(RandomIt first, IndexIt perm, std::size_t length) {
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+
+    std::vector<std::uint64_t> visited((length + 63) / 64, 0);
+    for (std::size_t start = 0; start < length; start++) {
+        if (visited[start / 64] & (std::uint64_t(1) << (start % 64))) {
+            continue;
+        }
+
+        ValueType held = std::move(first[start]);
+        std::size_t slot = start;
+        while (true) {
+            visited[slot / 64] |= std::uint64_t(1) << (slot % 64);
+            std::size_t source = static_cast<std::size_t>(perm[slot]);
+            if (source == start) {
+                first[slot] = std::move(held);
+                break;
+            }
+            first[slot] = std::move(first[source]);
+            slot = source;
+        }
+    }
+}
+
+
+/**
+ * @brief Reusable indirect shuffler for records of type T.
+ *
+ * Keeps the index array and the gather buffer between calls, so repeated shuffles of
+ * similarly sized arrays neither reallocate nor page-fault fresh memory. An instance
+ * must not be used from several threads at once.
+ */
+template <typename T, typename Index = std::uint32_t>
+class IndirectShuffler {
+    public:
+        /**
+         * @brief Shuffles [first, last) by shuffling an index array with
+         * `shuffleIndices(indexFirst, indexLast, rng)` and applying the result.
+         *
+         * With PermutationStrategy::Direct, `shuffleIndices` is applied to the records
+         * themselves.
+         */
+        template <typename RandomIt, typename URBG, typename IndexShuffle>
+        void operator()(
+            RandomIt first,
+            RandomIt last,
+            URBG& rng,
+            IndexShuffle shuffleIndices,
+            PermutationStrategy strategy = PermutationStrategy::Auto
+        ) {
+            std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+            if (strategy == PermutationStrategy::Auto) {
+                strategy = choosePermutationStrategy(sizeof(T), length);
+            }
+
+            if (strategy == PermutationStrategy::Direct) {
+                shuffleIndices(first, last, rng);
+                return;
+            }
+
+            m_indices.resize(length);
+            std::iota(m_indices.begin(), m_indices.end(), Index(0));
+            shuffleIndices(m_indices.begin(), m_indices.end(), rng);
+
+            if (strategy == PermutationStrategy::Gather) {
+                m_gathered.clear();
+                m_gathered.reserve(length);
+                gatherPermutation(first, m_indices.begin(), length, std::back_inserter(m_gathered));
+                std::move(m_gathered.begin(), m_gathered.end(), first);
+            } else {
+                applyPermutationInPlace(first, m_indices.begin(), length);
+            }
+        }
+
+    private:
+        std::vector<Index> m_indices;
+        std::vector<T> m_gathered;
+};
+
+
+/**
+ * @brief One-off indirect shuffle of [first, last); see IndirectShuffler.
+ *
+ * Indices are 32-bit whenever the length allows it.
+ */
+template <typename RandomIt, typename URBG, typename IndexShuffle>
+void indirectShuffle(
+    RandomIt first,
+    RandomIt last,
+    URBG& rng,
+    IndexShuffle shuffleIndices,
+    PermutationStrategy strategy = PermutationStrategy::Auto
+) {
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    if (length <= std::numeric_limits<std::uint32_t>::max()) {
+        IndirectShuffler<ValueType, std::uint32_t> shuffler;
+        shuffler(first, last, rng, shuffleIndices, strategy);
+    } else {
+        IndirectShuffler<ValueType, std::uint64_t> shuffler;
+        shuffler(first, last, rng, shuffleIndices, strategy);
+    }
+}
+
+/**
+ * @brief Indirect shuffle whose index array is shuffled with durstenfeldShuffle.
+ */
+template <typename RandomIt, typename URBG>
+void indirectShuffle(
+    RandomIt first,
+    RandomIt last,
+    URBG& rng,
+    PermutationStrategy strategy = PermutationStrategy::Auto
+) {
+    indirectShuffle(first, last, rng,
+        [](auto indexFirst, auto indexLast, URBG& engine) {
+            durstenfeldShuffle(indexFirst, indexLast, engine);
+        },
+        strategy
+    );
+}
+
+} // namespace shuffle
+
+#endif // SHUFFLE_PERMUTATION_HPP
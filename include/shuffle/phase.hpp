@@ -0,0 +1,71 @@
+#ifndef SHUFFLE_PHASE_HPP
+#define SHUFFLE_PHASE_HPP
+
+#include <cstddef>
+
+// Optional phase instrumentation.
+//
+// The algorithms announce the phases they go through to an observer installed on the
+// calling thread. Without an observer a PhaseScope costs one thread-local load, so the
+// hooks stay compiled in. Other threads (e.g. OpenMP workers) have no observer unless
+// they install one themselves.
+namespace shuffle {
+
+enum class Phase {
+    Init,       // Allocating and filling the identity permutation.
+    Shuffle,    // The shuffle call as a whole.
+    Merge,      // Random interleaving of two shuffled halves.
+    CopyBack,   // Moving a merged range from the scratch buffer back.
+    Stats,      // Accumulating statistics over shuffled output.
+    Count
+};
+
+// Merges and copy-backs over fewer elements than this are not announced separately,
+// so they are attributed to the enclosing phase.
+constexpr std::size_t kPhaseGranularity = std::size_t(1) << 16;
+
+// Returns a printable name of the phase.
+const char* phaseName(Phase phase);
+
+class PhaseObserver {
+    public:
+        virtual ~PhaseObserver() = default;
+
+        // Called when the calling thread enters and leaves a phase. Phases nest.
+        virtual void enterPhase(Phase phase) = 0;
+        virtual void leavePhase(Phase phase) = 0;
+};
+
+// Returns the observer installed on the calling thread, or nullptr.
+PhaseObserver* phaseObserver();
+
+// Installs `observer` on the calling thread; nullptr removes it.
+void setPhaseObserver(PhaseObserver* observer);
+
+// Announces a phase to the calling thread's observer for the lifetime of the scope.
+class PhaseScope {
+    public:
+        explicit PhaseScope(Phase phase, bool enabled = true)
+            : m_observer(enabled ? phaseObserver() : nullptr), m_phase(phase) {
+            if (m_observer != nullptr) {
+                m_observer->enterPhase(m_phase);
+            }
+        }
+
+        ~PhaseScope() {
+            if (m_observer != nullptr) {
+                m_observer->leavePhase(m_phase);
+            }
+        }
+
+        PhaseScope(const PhaseScope&) = delete;
+        PhaseScope& operator=(const PhaseScope&) = delete;
+
+    private:
+        PhaseObserver* m_observer;
+        Phase m_phase;
+};
+
+} // namespace shuffle
+
+#endif // SHUFFLE_PHASE_HPP
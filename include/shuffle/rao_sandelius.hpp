@@ -0,0 +1,254 @@
+#ifndef SHUFFLE_RAO_SANDELIUS_HPP
+#define SHUFFLE_RAO_SANDELIUS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "shuffle/algorithms.hpp"
+#include "shuffle/allocator.hpp"
+
+// Cache-blocked Rao–Sandelius shuffle.
+//
+// Once an array outgrows the cache, every swap of a Durstenfeld shuffle is a cache (and
+// often TLB) miss. Rao–Sandelius instead sends every element to one of 2^k buckets drawn
+// uniformly at random, in a single streaming pass, and then shuffles each bucket on its
+// own. Buckets are sized to fit in the L2 cache, so their shuffles run at cache speed;
+// buckets that are still too large are split again.
+namespace shuffle {
+
+// Upper bound on the buckets of one scatter pass. With a cache line of staging per bucket,
+// 1024 buckets keep the staging area at 64 KiB.
+constexpr unsigned int kMaxBucketBits = 10;
+
+// Bytes staged per bucket before they are written out together: one cache line.
+constexpr std::size_t kWriteCombineBytes = 64;
+
+// L2 cache size assumed when the C library cannot report one.
+constexpr std::size_t kDefaultL2CacheBytes = std::size_t(256) << 10;
+
+// Returns the size of the L2 cache in bytes, or kDefaultL2CacheBytes if it is unknown.
+inline std::size_t detectedL2CacheBytes() {
+    std::size_t bytes = detectedCacheBytes(2);
+    return bytes > 0 ? bytes : kDefaultL2CacheBytes;
+}
+
+
+namespace detail {
+
+// Elements of type T staged per bucket: as many as fill a cache line, and at least one.
+template <typename T>
+constexpr std::size_t writeCombineElements() {
+    return sizeof(T) < kWriteCombineBytes ? kWriteCombineBytes / sizeof(T) : 1;
+}
+
+// Number of random bits one call of URBG yields, if its range is [0, 2^w - 1]; else 0.
+template <typename URBG>
+constexpr unsigned int fullRangeBits() {
+    using Result = typename URBG::result_type;
+    Result max = (URBG::max)();
+    if ((URBG::min)() != 0 || (max & (max + 1)) != 0) {
+        return 0;
+    }
+    unsigned int bits = 0;
+    while (max != 0) {
+        max >>= 1;
+        bits++;
+    }
+    return bits;
+}
+
+// Draws uniform labels of `bits` bits. From engines with a power-of-two range, each call
+// of the engine is split into as many labels as it holds.
+template <typename URBG>
+class RandomLabels {
+    public:
+        RandomLabels(URBG& rng, unsigned int bits)
+            : m_rng(rng), m_bits(bits), m_mask((std::size_t(1) << bits) - 1), m_word(0), m_available(0) {}
+
+        std::size_t next() {
+            constexpr unsigned int wordBits = fullRangeBits<URBG>();
+            if constexpr (wordBits > 0) {
+                if (m_available < m_bits) {
+                    m_word = static_cast<unsigned long long>(m_rng());
+                    m_available = wordBits;
+                }
+                std::size_t label = static_cast<std::size_t>(m_word) & m_mask;
+                m_word >>= m_bits;
+                m_available -= m_bits;
+                return label;
+            } else {
+                return uniformIndex(m_rng, 0, m_mask);
+            }
+        }
+
+    private:
+        URBG& m_rng;
+        unsigned int m_bits;
+        std::size_t m_mask;
+        unsigned long long m_word;
+        unsigned int m_available;
+};
+
+// Counts how many of the next n labels drawn from `rng` fall into each of the 2^bits
+// buckets, using a copy of the engine so that the caller can replay the same labels.
+// Returns the bucket offsets: bucket b is [bounds[b], bounds[b + 1]).
+template <typename URBG>
+std::vector<std::size_t> countBuckets(const URBG& rng, std::size_t n, unsigned int bits) {
+    std::vector<std::size_t> bounds((std::size_t(1) << bits) + 1, 0);
+    URBG replay = rng;
+    RandomLabels<URBG> labels(replay, bits);
+    for (std::size_t i = 0; i < n; i++) {
+        bounds[labels.next() + 1]++;
+    }
+    for (std::size_t b = 1; b < bounds.size(); b++) {
+        bounds[b] += bounds[b - 1];
+    }
+    return bounds;
+}
+
+// Sends source(0), ..., source(n - 1) to the buckets of dst[0, n) described by `bounds`,
+// drawing their labels from `rng` in the same order as countBuckets. Each bucket's
+// elements are staged in a buffer of writeCombineElements<T>() elements, one cache line
+// for elements up to 64 bytes, so the output is written in whole lines rather than one
+// element at a time.
+template <typename T, typename OutputIt, typename URBG, typename Source>
+void scatterToBuckets(
+    OutputIt dst,
+    std::size_t n,
+    URBG& rng,
+    unsigned int bits,
+    const std::vector<std::size_t>& bounds,
+    Source&& source
+) {
+    constexpr std::size_t stagedElements = writeCombineElements<T>();
+    std::size_t buckets = std::size_t(1) << bits;
+    std::vector<std::size_t> cursors(bounds.begin(), bounds.end() - 1);
+    std::vector<T> staging(buckets * stagedElements);
+    std::vector<unsigned int> staged(buckets, 0);
+
+    RandomLabels<URBG> labels(rng, bits);
+    for (std::size_t i = 0; i < n; i++) {
+        std::size_t b = labels.next();
+        T* slot = staging.data() + b * stagedElements;
+        slot[staged[b]++] = source(i);
+        if (staged[b] == stagedElements) {
+            std::move(slot, slot + stagedElements, dst + cursors[b]);
+            cursors[b] += stagedElements;
+            staged[b] = 0;
+        }
+    }
+    for (std::size_t b = 0; b < buckets; b++) {
+        T* slot = staging.data() + b * stagedElements;
+        std::move(slot, slot + staged[b], dst + cursors[b]);
+    }
+}
+
+// Number of label bits that split n elements into buckets of at most blockElements,
+// capped at kMaxBucketBits.
+inline unsigned int bucketBits(std::size_t n, std::size_t blockElements) {
+    unsigned int bits = 1;
+    while (bits < kMaxBucketBits && (blockElements << bits) < n) {
+        bits++;
+    }
+    return bits;
+}
+
+template <typename RandomIt, typename ScratchIt, typename URBG>
+void raoSandeliusRec(RandomIt arr, ScratchIt temp, std::size_t n, URBG& rng, std::size_t blockElements) {
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+
+    if (n <= blockElements) {
+        durstenfeldShuffle(arr, arr + n, rng);
+        return;
+    }
+
+    unsigned int bits = bucketBits(n, blockElements);
+    std::vector<std::size_t> bounds = countBuckets(rng, n, bits);
+    scatterToBuckets<ValueType>(temp, n, rng, bits, bounds,
+        [&arr](std::size_t i) { return std::move(arr[i]); }
+    );
+
+    // Bring every bucket back in order and shuffle it while it is still in the cache.
+    for (std::size_t b = 0; b + 1 < bounds.size(); b++) {
+        std::move(temp + bounds[b], temp + bounds[b + 1], arr + bounds[b]);
+        raoSandeliusRec(arr + bounds[b], temp, bounds[b + 1] - bounds[b], rng, blockElements);
+    }
+}
+
+// Bucket size in elements for blocks of `blockBytes` bytes, 0 meaning half the L2 cache.
+template <typename T>
+std::size_t blockElementsFor(std::size_t blockBytes) {
+    if (blockBytes == 0) {
+        blockBytes = detectedL2CacheBytes() / 2;
+    }
+    return std::max<std::size_t>(kMergeThreshold, blockBytes / sizeof(T));
+}
+
+} // namespace detail
+
+
+/**
+ * @brief Cache-blocked Rao–Sandelius shuffle, staging the scatter pass in
+ * [scratch, scratch + n).
+ *
+ * Buckets are meant to hold about `blockBytes` bytes each; with the default of 0, half
+ * of the detected L2 cache is used. Unbiased: every element picks its bucket uniformly
+ * and independently, and every bucket is shuffled uniformly.
+ */
+template <typename RandomIt, typename ScratchIt, typename URBG>
+void raoSandeliusShuffle(RandomIt first, RandomIt last, ScratchIt scratch, URBG& rng, std::size_t blockBytes = 0) {
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    detail::raoSandeliusRec(first, scratch, length, rng, detail::blockElementsFor<ValueType>(blockBytes));
+}
+
+template <typename RandomIt, typename URBG>
+void raoSandeliusShuffle(RandomIt first, RandomIt last, URBG& rng) {
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+    std::vector<ValueType> temp(static_cast<std::size_t>(std::distance(first, last)));
+    raoSandeliusShuffle(first, last, temp.begin(), rng);
+}
+
+/**
+ * @brief Rao–Sandelius shuffle that writes a uniformly random permutation of
+ * value(0), ..., value(n - 1) into [first, last).
+ *
+ * The values are scattered into their buckets as they are generated, so the range is
+ * written once and never read first, as with insideOutShuffle. Scratch space is only
+ * allocated for buckets too large for the cache, and only as large as the largest one.
+ */
+template <typename RandomIt, typename URBG, typename Generator>
+void raoSandeliusGenerate(RandomIt first, RandomIt last, URBG& rng, Generator value, std::size_t blockBytes = 0) {
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+
+    std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+    std::size_t blockElements = detail::blockElementsFor<ValueType>(blockBytes);
+    if (length <= blockElements) {
+        for (std::size_t i = 0; i < length; i++) {
+            first[i] = value(i);
+        }
+        durstenfeldShuffle(first, last, rng);
+        return;
+    }
+    unsigned int bits = detail::bucketBits(length, blockElements);
+
+    std::vector<std::size_t> bounds = detail::countBuckets(rng, length, bits);
+    detail::scatterToBuckets<ValueType>(first, length, rng, bits, bounds, value);
+
+    std::size_t largest = 0;
+    for (std::size_t b = 0; b + 1 < bounds.size(); b++) {
+        largest = std::max(largest, bounds[b + 1] - bounds[b]);
+    }
+    std::vector<ValueType> temp(largest > blockElements ? largest : 0);
+    for (std::size_t b = 0; b + 1 < bounds.size(); b++) {
+        detail::raoSandeliusRec(first + bounds[b], temp.begin(), bounds[b + 1] - bounds[b], rng, blockElements);
+    }
+}
+
+} // namespace shuffle
+
+#endif // SHUFFLE_RAO_SANDELIUS_HPP
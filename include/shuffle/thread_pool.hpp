@@ -0,0 +1,140 @@
+#ifndef SHUFFLE_THREAD_POOL_HPP
+#define SHUFFLE_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// A small work-stealing scheduler.
+//
+// Every worker owns a deque: it pushes and pops its own tasks at the back and other
+// threads steal from the front. Threads outside the pool submit into a shared injection
+// queue that is used the same way and, while waiting on a TaskGroup, help by running
+// queued or stolen tasks, so a service can lend its own request thread to a shuffle
+// instead of oversubscribing the machine with a separate OpenMP team.
+namespace shuffle {
+
+// Counters of one participant of the pool. Participant 0 stands for all threads outside
+// the pool that helped while waiting; participants 1..workers() are the workers.
+struct WorkerStats {
+    std::uint64_t tasksExecuted = 0;
+    std::uint64_t tasksStolen = 0;
+    std::uint64_t failedSteals = 0;
+    std::uint64_t idleNanoseconds = 0;
+};
+
+class WorkStealingPool {
+    public:
+        // Starts `workers` worker threads; with 0 every task runs on the waiting thread.
+        explicit WorkStealingPool(unsigned int workers);
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        unsigned int workers() const;
+
+        // Returns the counters of every participant, caller slot first.
+        std::vector<WorkerStats> stats() const;
+        void resetStats();
+
+    private:
+        friend class TaskGroup;
+
+        using Task = std::function<void()>;
+
+        struct alignas(64) Participant {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+            std::atomic<std::uint64_t> tasksExecuted{0};
+            std::atomic<std::uint64_t> tasksStolen{0};
+            std::atomic<std::uint64_t> failedSteals{0};
+            std::atomic<std::uint64_t> idleNanoseconds{0};
+        };
+
+        // Queues a task on the calling worker's deque, or on the injection queue.
+        void submit(Task task);
+
+        // Runs one queued task if there is any; returns false otherwise.
+        bool runOne();
+
+        bool popLocal(std::size_t self, Task& task);
+        bool steal(std::size_t self, Task& task);
+        void workerLoop(std::size_t self);
+
+        // Index of the calling thread in m_participants, or 0 outside this pool.
+        std::size_t currentParticipant() const;
+
+        std::vector<std::unique_ptr<Participant>> m_participants;
+        std::vector<std::thread> m_threads;
+
+        std::atomic<std::size_t> m_queued{0};
+        std::atomic<unsigned int> m_sleepers{0};
+        std::atomic<bool> m_stopping{false};
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wake;
+};
+
+/**
+ * @brief A set of tasks that can be waited for together.
+ *
+ * wait() keeps running queued tasks (its own or stolen ones) until every task of the
+ * group has finished, so nested groups never block a worker. If tasks threw, wait()
+ * rethrows the first of their exceptions once all of them have finished.
+ */
+class TaskGroup {
+    public:
+        explicit TaskGroup(WorkStealingPool& pool) : m_pool(pool), m_pending(0) {}
+
+        // Waits for the tasks without rethrowing; call wait() first to see their errors.
+        ~TaskGroup() { drain(); }
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        template <typename F>
+        void run(F&& function) {
+            m_pending.fetch_add(1);
+            m_pool.submit([this, function = std::forward<F>(function)]() mutable {
+                Completion completion{m_pending};
+                try {
+                    function();
+                } catch (...) {
+                    recordException(std::current_exception());
+                }
+            });
+        }
+
+        void wait();
+
+    private:
+        // Marks a task as finished when it goes out of scope, however the task ended.
+        struct Completion {
+            std::atomic<std::size_t>& pending;
+            ~Completion() { pending.fetch_sub(1); }
+        };
+
+        // Keeps `error` if it is the first exception of the group.
+        void recordException(std::exception_ptr error);
+
+        // Runs queued tasks until every task of the group has finished.
+        void drain();
+
+        WorkStealingPool& m_pool;
+        std::atomic<std::size_t> m_pending;
+        std::mutex m_errorMutex;
+        std::exception_ptr m_error;
+};
+
+} // namespace shuffle
+
+#endif // SHUFFLE_THREAD_POOL_HPP
@@ -0,0 +1,59 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "util/helpers.hpp"
+#include "util/memory_usage.hpp"
+#include "util/shuffler.hpp"
+
+
+// Latency distribution of repeated shuffle calls, in nanoseconds.
+struct BenchmarkResult {
+    std::string algorithm;
+    unsigned int length;
+    unsigned int warmup;
+    unsigned int repetitions;
+    std::vector<std::uint64_t> samples;   // Sorted ascending.
+    std::uint64_t min;
+    std::uint64_t p50;
+    std::uint64_t p90;
+    std::uint64_t p99;
+    std::uint64_t max;
+    double mean;
+    double throughput;                    // Elements per second at the median latency.
+    MemoryUsage memory;                   // Over the timed calls.
+};
+
+/**
+ * @brief Times individual calls of the shuffle method with nanosecond resolution.
+ *
+ * Only the shuffle call itself is timed; `warmup` untimed calls run first. Allocations
+ * and peak resident memory are measured over the timed calls.
+ *
+ * @param shuffler An instance of NumbersShuffler.
+ * @param func A pointer to the shuffle function to time.
+ * @param funcName The name of the function.
+ * @param length The length of the permutation.
+ * @param warmup How many untimed calls to make first.
+ * @param repetitions How many calls to time.
+ */
+BenchmarkResult runBenchmark(
+    NumbersShuffler& shuffler,
+    ShuffleFunc func,
+    const std::string& funcName,
+    unsigned int length,
+    unsigned int warmup,
+    unsigned int repetitions
+);
+
+// Prints the latency summary.
+void printBenchmark(const BenchmarkResult& result);
+
+// Writes the summary to `path` as "json" (overwriting) or "csv" (appending a row, with a
+// header if the file is new). Throws std::runtime_error if the file cannot be written.
+void writeBenchmark(const BenchmarkResult& result, const std::string& path, const std::string& format);
+
+#endif // BENCHMARK_HPP
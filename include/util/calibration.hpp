@@ -0,0 +1,43 @@
+#ifndef CALIBRATION_HPP
+#define CALIBRATION_HPP
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "util/helpers.hpp"
+#include "util/shuffler.hpp"
+
+
+// Default location of the calibration profile.
+extern const char* const kDefaultProfilePath;
+
+// One measurement of the calibration grid.
+struct CalibrationEntry {
+    unsigned int length;
+    int threads;
+    std::string algorithm;
+    double nanoseconds;   // Best observed time of a single call.
+};
+
+/**
+ * @brief Times every unbiased algorithm across a grid of permutation lengths (powers
+ * of four up to maxLength) and OpenMP thread counts (powers of two up to the maximum),
+ * prints the fastest algorithm per grid point and saves the measurements.
+ *
+ * @param shuffler An instance of NumbersShuffler.
+ * @param maxLength The largest permutation length to measure.
+ * @param profilePath Where to write the profile.
+ */
+void runCalibration(NumbersShuffler& shuffler, unsigned int maxLength, const std::string& profilePath);
+
+// Reads a profile written by runCalibration().
+// Throws std::runtime_error if the file cannot be opened or is malformed.
+std::vector<CalibrationEntry> loadProfile(const std::string& profilePath);
+
+// Returns a pair (algorithm name, function pointer) for the algorithm that the profile
+// found fastest at the grid point closest to `length` and the current thread count.
+// Falls back to durstenfeldShuffle, with a warning, if no usable profile exists.
+std::pair<std::string, ShuffleFunc> selectAutoAlgorithm(const std::string& profilePath, unsigned int length);
+
+#endif // CALIBRATION_HPP
@@ -1,6 +1,8 @@
 #ifndef COMMAND_LINE_HPP
 #define COMMAND_LINE_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 // Holds the parsed command-line options.
@@ -9,6 +11,18 @@ struct ProgramOptions {
     unsigned int permutationLength;
     unsigned int iterations;
     std::string algorithm;
+    std::string profilePath;
+    bool perf;
+    bool hugePages;
+    unsigned int warmup;
+    unsigned int repetitions;
+    std::string outputPath;
+    std::string outputFormat;
+    unsigned int threads;     // 0 keeps the OpenMP default.
+    std::size_t grain;        // 0 keeps the default task-granularity cutoff.
+    std::string runtime;      // "openmp" or "pool".
+    bool stream;              // Generate mode streams binary permutations (--count given).
+    std::uint64_t count;      // Permutations to stream; 0 is unbounded.
 };
 
 // Prints the usage information.
@@ -4,24 +4,41 @@
 #include <string>
 #include <vector>
 #include <utility>
+#include "shuffle/thread_pool.hpp"
 #include "util/shuffler.hpp"
 
 
 // A pointer‐to‐member function type for a NumbersShuffler shuffle method.
-using ShuffleFunc = std::vector<unsigned int> (NumbersShuffler::*)(unsigned int) const;
+using ShuffleFunc = Permutation (NumbersShuffler::*)(unsigned int);
 
 // Structure for pairing an algorithm’s name with its function pointer.
 struct Algorithm {
     std::string name;
     ShuffleFunc func;
+    bool unbiased;   // Produces every permutation with equal probability.
+    bool parallel;   // Runs on multiple OpenMP threads.
 };
 
+// Returns every available algorithm, in the order of their 1-based indices.
+std::vector<Algorithm> availableAlgorithms();
+
 // Returns a pair (algorithm name, function pointer) based on the provided argument.
 // Throws std::runtime_error if the algorithm cannot be found.
 std::pair<std::string, ShuffleFunc> selectAlgorithm(const std::string &algorithmArg);
 
+// Prints the per-participant task, steal and idle counters of a work-stealing pool.
+void printPoolStats(const shuffle::WorkStealingPool &pool);
+
 // Prints the permutation.
-void printPermutation(const std::vector<unsigned int> &perm, const std::string &funcName);
+void printPermutation(const Permutation &perm, const std::string &funcName);
+
+// Prints how the permutation's pages are spread over NUMA nodes, relative to the
+// per-thread chunks of the NUMA-aware algorithms.
+void printNumaPlacement(const Permutation &perm);
+
+// Prints how many huge-page-backed buffers were obtained so far and, if given, how much
+// of the permutation is currently backed by huge pages.
+void printHugePageReport(const Permutation *perm);
 
 // Calls the shuffling algorithm and prints the shuffled list.
 void generateShuffledList(
@@ -0,0 +1,59 @@
+#ifndef MEMORY_USAGE_HPP
+#define MEMORY_USAGE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+
+// Allocations made through operator new (counted by the replacement operators in
+// memory_usage.cpp) plus the buffers libshuffle maps with mmap.
+struct AllocationCounters {
+    std::uint64_t allocations;
+    std::uint64_t bytes;
+};
+
+// Returns the counters accumulated since the start of the process.
+AllocationCounters allocationCounters();
+
+// Memory used while a MemoryMonitor was running.
+struct MemoryUsage {
+    std::uint64_t allocations;
+    std::uint64_t allocatedBytes;
+    std::uint64_t startResidentBytes;
+    std::uint64_t peakResidentBytes;
+    bool sampled;                       // Peak found by sampling, not by the kernel.
+};
+
+/**
+ * @brief Measures allocations and the resident set between construction and stop().
+ *
+ * The peak resident set is taken from the kernel's VmHWM after resetting it through
+ * /proc/self/clear_refs. Where that reset is not permitted, a thread samples the resident
+ * set every millisecond instead, which can miss peaks shorter than that.
+ */
+class MemoryMonitor {
+    public:
+        MemoryMonitor();
+        ~MemoryMonitor();
+
+        MemoryMonitor(const MemoryMonitor&) = delete;
+        MemoryMonitor& operator=(const MemoryMonitor&) = delete;
+
+        MemoryUsage stop();
+
+    private:
+        AllocationCounters m_start;
+        std::uint64_t m_startResident;
+        bool m_peakReset;
+        std::atomic<bool> m_running;
+        std::atomic<std::uint64_t> m_sampledPeak;
+        std::thread m_sampler;
+};
+
+// Prints allocation count, bytes allocated and peak resident memory, with per-call
+// averages over `calls` shuffles.
+void printMemoryUsage(const MemoryUsage& usage, unsigned int calls);
+
+#endif // MEMORY_USAGE_HPP
@@ -0,0 +1,93 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "shuffle/phase.hpp"
+
+
+// Hardware events recorded by PerfCounters.
+enum PerfEvent {
+    kPerfCycles,
+    kPerfInstructions,
+    kPerfLlcMisses,
+    kPerfDtlbMisses,
+    kPerfBranchMisses,
+    kPerfEventCount
+};
+
+// Cumulative counter values; events that could not be opened stay invalid.
+struct PerfSample {
+    std::array<std::uint64_t, kPerfEventCount> values{};
+    std::array<bool, kPerfEventCount> valid{};
+    std::uint64_t nanoseconds = 0;
+    // How long the group was enabled and how long it was actually counting. The two
+    // differ when the kernel multiplexes more events than the PMU has counters.
+    std::uint64_t timeEnabled = 0;
+    std::uint64_t timeRunning = 0;
+};
+
+/**
+ * @brief Counts hardware events of the calling thread through Linux perf_event_open.
+ *
+ * All events that the kernel and PMU accept are opened as one group, so a sample costs a
+ * single read(). Events that cannot be opened (e.g. dTLB misses inside many VMs) are
+ * left out; if none can, available() is false and samples only carry wall-clock time.
+ * Samples also carry the group's enabled and running times, so that counts of a group
+ * that was multiplexed can be scaled up, and those of one never scheduled discarded.
+ */
+class PerfCounters {
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        bool available() const;
+
+        // Explains why no counter could be opened.
+        const std::string& unavailableReason() const;
+
+        // Returns the current cumulative values.
+        PerfSample read() const;
+
+    private:
+        int m_leaderFd;
+        std::vector<int> m_fds;
+        std::vector<PerfEvent> m_events;   // Group members, in the order the kernel reports them.
+        std::string m_unavailableReason;
+};
+
+/**
+ * @brief Attributes counter deltas to the innermost active shuffle::Phase.
+ *
+ * Install it with shuffle::setPhaseObserver() on the thread that runs the algorithm.
+ * Work outside of any phase is attributed to shuffle::Phase::Count ("other"). Counts of
+ * a phase are scaled by its enabled over running time, and shown as "n/a" if the group
+ * never ran during the phase.
+ */
+class PhaseProfiler : public shuffle::PhaseObserver {
+    public:
+        explicit PhaseProfiler(const PerfCounters& counters);
+
+        void enterPhase(shuffle::Phase phase) override;
+        void leavePhase(shuffle::Phase phase) override;
+
+        // Prints a table of the accumulated counters per phase and in total.
+        void printReport(const std::string& funcName);
+
+    private:
+        // Adds the counts since the previous sample to the innermost phase.
+        void attribute();
+
+        const PerfCounters& m_counters;
+        PerfSample m_last;
+        std::vector<shuffle::Phase> m_stack;
+        std::array<PerfSample, static_cast<std::size_t>(shuffle::Phase::Count) + 1> m_totals;
+};
+
+#endif // PERF_COUNTERS_HPP
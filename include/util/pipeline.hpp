@@ -0,0 +1,51 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <cstdint>
+#include <string>
+
+
+// Sustained throughput of a streaming generation run.
+struct PipelineResult {
+    std::string algorithm;
+    unsigned int length;
+    unsigned int workers;
+    std::uint64_t permutations;   // Permutations written.
+    std::uint64_t bytes;          // Bytes written.
+    double seconds;
+    double workerWaitSeconds;     // Total time workers waited for a free buffer.
+    double writerWaitSeconds;     // Time the writer waited for a filled buffer.
+    bool outputClosed;            // The reader went away before `count` was reached.
+};
+
+/**
+ * @brief Streams independent permutations of 1..length as raw native-endian 32-bit
+ * integers, one permutation after another.
+ *
+ * `workers` threads shuffle into a fixed set of recycled buffers, each holding a batch
+ * of permutations, while a writer thread emits finished batches. Workers block when
+ * every buffer is waiting to be written, so a slow reader throttles generation instead
+ * of growing memory. Batches are written in completion order.
+ *
+ * Throws std::runtime_error if the algorithm is unknown or parallel, the output cannot
+ * be opened or stdout is a terminal. If a worker throws, the run stops and the first
+ * such exception is rethrown on the calling thread.
+ *
+ * @param algorithm The name of a sequential algorithm of availableAlgorithms().
+ * @param length The length of every permutation.
+ * @param count How many permutations to write; 0 streams until the reader goes away.
+ * @param outputPath The file to write, or empty for stdout.
+ * @param workers How many shuffling threads to run.
+ */
+PipelineResult runGenerationPipeline(
+    const std::string& algorithm,
+    unsigned int length,
+    std::uint64_t count,
+    const std::string& outputPath,
+    unsigned int workers
+);
+
+// Prints the throughput summary to stderr, leaving stdout to the permutations.
+void printPipelineResult(const PipelineResult& result);
+
+#endif // PIPELINE_HPP
@@ -0,0 +1,14 @@
+#ifndef RECORDS_HPP
+#define RECORDS_HPP
+
+
+/**
+ * @brief Benchmarks shuffling of 64, 128 and 256 byte records, comparing direct
+ * Durstenfeld swapping against the indirect gather and cycle-following strategies.
+ *
+ * @param length The number of records to shuffle.
+ * @param iterations How many shuffles to time per strategy.
+ */
+void produceRecordBenchmark(unsigned int length, unsigned int iterations);
+
+#endif // RECORDS_HPP
@@ -1,48 +1,77 @@
 #ifndef NUMBERS_SHUFFLER_HPP
 #define NUMBERS_SHUFFLER_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <random>
 #include <vector>
 
+#include "shuffle/algorithms.hpp"
+#include "shuffle/allocator.hpp"
+#include "shuffle/thread_pool.hpp"
+
+// A permutation of 1..n. Its allocator leaves elements uninitialised until written.
+using Permutation = std::vector<unsigned int, shuffle::BufferAllocator<unsigned int>>;
+
+/**
+ * Generates shuffled permutations of 1..n with each of the available algorithms.
+ *
+ * Thread safety: every instance owns its random state (a Mersenne Twister, and a
+ * rand()-style generator for the biased algorithms) and instances share no mutable
+ * state, so any number of instances may shuffle concurrently. A single instance must
+ * not be used from several threads at once; give every thread its own instance, e.g.
+ * one obtained with fork().
+ */
 class NumbersShuffler {
     public:
-        std::vector<unsigned int> biasedNaiveShuffle(unsigned int length) const;
-        std::vector<unsigned int> naiveShuffle(unsigned int length) const;
-        std::vector<unsigned int> biasedFisherYatesShuffle(unsigned int length) const;
-        std::vector<unsigned int> fisherYatesShuffle(unsigned int length) const;
-        std::vector<unsigned int> biasedDurstenfeldShuffle(unsigned int length) const;
-        std::vector<unsigned int> durstenfeldShuffle(unsigned int length) const;
-        std::vector<unsigned int> randomShuffle(unsigned int length) const;
-        std::vector<unsigned int> mergeShuffle(unsigned int length) const;
-        std::vector<unsigned int> parallelMergeShuffle(unsigned int length) const;
+        Permutation biasedNaiveShuffle(unsigned int length);
+        Permutation naiveShuffle(unsigned int length);
+        Permutation biasedFisherYatesShuffle(unsigned int length);
+        Permutation fisherYatesShuffle(unsigned int length);
+        Permutation biasedDurstenfeldShuffle(unsigned int length);
+        Permutation durstenfeldShuffle(unsigned int length);
+        Permutation randomShuffle(unsigned int length);
+        Permutation mergeShuffle(unsigned int length);
+        Permutation parallelMergeShuffle(unsigned int length);
+        Permutation numaParallelMergeShuffle(unsigned int length);
+        Permutation lehmerShuffle(unsigned int length);
+        Permutation insideOutShuffle(unsigned int length);
+        Permutation insideOutMergeShuffle(unsigned int length);
+        Permutation raoSandeliusShuffle(unsigned int length);
 
+        // Seeds the instance from std::random_device.
         NumbersShuffler();
+
+        // Seeds the instance deterministically, so that its output can be reproduced.
+        explicit NumbersShuffler(std::uint32_t seed);
+
+        // Reseeds both generators of the instance.
+        void seed(std::uint32_t seed);
+
+        // Returns a copy with the same settings, seeded from this instance's engine, for
+        // another thread to use.
+        NumbersShuffler fork();
+
+        // Runs parallelMergeShuffle on `pool` instead of OpenMP; nullptr restores OpenMP.
+        // The pool must outlive every call made while it is set.
+        void setThreadPool(shuffle::WorkStealingPool* pool);
+
+        // Sets the size below which the parallel algorithms stop splitting work into
+        // tasks; 0 restores the default of the active runtime.
+        void setGrain(std::size_t grain);
     private:
-        // Static flag to ensure std::rand() is seeded only once.
-        static bool s_randSeeded;
-    
-        // Static mt19937 engine, seeded once using std::random_device.
-        static std::mt19937 s_mtEngine;
-
-        // A thread-local engine for safe concurrent use.
-        static std::mt19937& getThreadLocalEngine() {
-            thread_local std::mt19937 engine(std::random_device{}());
-            return engine;
-        }
-
-        static void mergeShuffleRec(
-            std::vector<unsigned int>& arr,
-            std::vector<unsigned int>& temp,
-            unsigned int start,
-            unsigned int end
-        );
-
-        static void parallelMergeShuffleRec(
-            std::vector<unsigned int>& arr,
-            std::vector<unsigned int>& temp,
-            unsigned int start,
-            unsigned int end
-        );
+        shuffle::WorkStealingPool* m_pool;
+        std::size_t m_grain;
+
+        // Engine of the unbiased algorithms; the parallel ones seed their per-thread
+        // engines from it.
+        std::mt19937 m_mtEngine;
+
+        // Low-quality source of the biased algorithms.
+        shuffle::RandLcgEngine m_randEngine;
+
+        // Returns the numbers 1 through length in order.
+        static Permutation identityPermutation(unsigned int length);
 };
 
 #endif // NUMBERS_SHUFFLER_HPP
@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 
+#include "shuffle/thread_pool.hpp"
 #include "util/helpers.hpp"
 #include "util/shuffler.hpp"
 
@@ -16,13 +17,16 @@
  * @param funcName The name of the function.
  * @param length The length of the permutation (i.e. numbers 1..length).
  * @param iterations How many shuffles to perform.
+ * @param pool If not null, the iterations are spread over this pool in batches, each
+ *        shuffling with its own shuffler.fork(), so any algorithm can be used.
  */
 void produceShuffleStats(
     NumbersShuffler& shuffler,
     ShuffleFunc func,
     const std::string& funcName,
     unsigned int length,
-    unsigned int iterations
+    unsigned int iterations,
+    shuffle::WorkStealingPool* pool = nullptr
 );
 
 #endif // STATISTICS_H
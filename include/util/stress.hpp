@@ -0,0 +1,43 @@
+#ifndef STRESS_HPP
+#define STRESS_HPP
+
+#include <string>
+#include <vector>
+
+#include "util/helpers.hpp"
+#include "util/shuffler.hpp"
+
+
+// Aggregate throughput of one thread count in the stress benchmark.
+struct StressPoint {
+    unsigned int threads;
+    double seconds;
+    double shufflesPerSecond;
+    double speedup;       // Relative to one thread.
+    double efficiency;    // Speedup divided by the thread count.
+};
+
+/**
+ * @brief Runs the shuffle method concurrently from 1, 2, 4, ... up to `maxThreads`
+ * threads, each making `iterations` calls on its own fork of `shuffler`.
+ *
+ * The work per thread is fixed, so with no shared state the aggregate throughput should
+ * grow linearly with the thread count until the cores or memory bandwidth run out.
+ */
+std::vector<StressPoint> runStressBenchmark(
+    NumbersShuffler& shuffler,
+    ShuffleFunc func,
+    unsigned int length,
+    unsigned int iterations,
+    unsigned int maxThreads
+);
+
+// Prints the throughput and scaling of every thread count.
+void printStressBenchmark(
+    const std::string& funcName,
+    unsigned int length,
+    unsigned int iterations,
+    const std::vector<StressPoint>& points
+);
+
+#endif // STRESS_HPP
@@ -1,35 +1,122 @@
 #ifndef MAIN_CPP
 #define MAIN_CPP
 
+#include <omp.h>
+
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
+#include "util/benchmark.hpp"
+#include "util/calibration.hpp"
+#include "shuffle/allocator.hpp"
+#include "shuffle/phase.hpp"
+#include "shuffle/thread_pool.hpp"
 #include "util/command_line.hpp"
 #include "util/helpers.hpp"
+#include "util/perf_counters.hpp"
+#include "util/pipeline.hpp"
+#include "util/records.hpp"
 #include "util/statistics.hpp"
+#include "util/stress.hpp"
 #include "util/shuffler.hpp"
 
 
 int main(int argc, char* argv[]) {
     try {
         ProgramOptions options = parseArguments(argc, argv);
-        std::pair<std::string, ShuffleFunc> algorithmPair = selectAlgorithm(options.algorithm);
+        shuffle::setHugePagesEnabled(options.hugePages);
+        NumbersShuffler shuffler;
+
+        if (options.threads > 0) {
+            omp_set_num_threads(static_cast<int>(options.threads));
+        }
+        shuffler.setGrain(options.grain);
+
+        // The calling thread takes part in the pool's work, so it needs one worker less.
+        std::unique_ptr<shuffle::WorkStealingPool> pool;
+        if (options.runtime == "pool") {
+            unsigned int threads = options.threads > 0
+                ? options.threads
+                : static_cast<unsigned int>(omp_get_max_threads());
+            pool = std::make_unique<shuffle::WorkStealingPool>(threads - 1);
+            shuffler.setThreadPool(pool.get());
+        }
+
+        if (options.mode == "records") {
+            produceRecordBenchmark(options.permutationLength, options.iterations);
+            return 0;
+        }
+        if (options.mode == "calibrate") {
+            runCalibration(shuffler, options.permutationLength, options.profilePath);
+            return 0;
+        }
+
+        std::pair<std::string, ShuffleFunc> algorithmPair = options.algorithm == "auto"
+            ? selectAutoAlgorithm(options.profilePath, options.permutationLength)
+            : selectAlgorithm(options.algorithm);
         std::string chosenName = algorithmPair.first;
         ShuffleFunc chosenFunc = algorithmPair.second;
 
-        NumbersShuffler shuffler;
+        // Hardware counters are attributed to phases through the calling thread's observer.
+        std::unique_ptr<PerfCounters> counters;
+        std::unique_ptr<PhaseProfiler> profiler;
+        if (options.perf) {
+            counters = std::make_unique<PerfCounters>();
+            profiler = std::make_unique<PhaseProfiler>(*counters);
+            shuffle::setPhaseObserver(profiler.get());
+        }
 
-        if (options.mode == "generate") {
+        if (options.mode == "generate" && options.stream) {
+            unsigned int workers = options.threads > 0
+                ? options.threads
+                : static_cast<unsigned int>(omp_get_max_threads());
+            PipelineResult result = runGenerationPipeline(
+                chosenName, options.permutationLength, options.count, options.outputPath, workers
+            );
+            printPipelineResult(result);
+        } else if (options.mode == "generate") {
             generateShuffledList(shuffler, chosenFunc, chosenName, options.permutationLength);
         } else if (options.mode == "stats") {
             produceShuffleStats(
-                shuffler, chosenFunc, chosenName, options.permutationLength, options.iterations
+                shuffler, chosenFunc, chosenName, options.permutationLength, options.iterations, pool.get()
+            );
+        } else if (options.mode == "bench") {
+            BenchmarkResult result = runBenchmark(
+                shuffler, chosenFunc, chosenName, options.permutationLength,
+                options.warmup, options.repetitions
+            );
+            printBenchmark(result);
+            if (!options.outputPath.empty()) {
+                writeBenchmark(result, options.outputPath, options.outputFormat);
+            }
+        } else if (options.mode == "stress") {
+            unsigned int maxThreads = options.threads > 0
+                ? options.threads
+                : std::max(1u, std::thread::hardware_concurrency());
+            std::vector<StressPoint> points = runStressBenchmark(
+                shuffler, chosenFunc, options.permutationLength, options.iterations, maxThreads
             );
+            printStressBenchmark(chosenName, options.permutationLength, options.iterations, points);
         } else {
             throw std::runtime_error("Error: unknown mode: " + options.mode);
         }
+
+        if (profiler) {
+            shuffle::setPhaseObserver(nullptr);
+            profiler->printReport(chosenName);
+        }
+        if (pool) {
+            printPoolStats(*pool);
+        }
+        if (options.hugePages && options.mode != "generate") {
+            printHugePageReport(nullptr);
+        }
     }
     catch (const std::exception &ex) {
         std::cerr << ex.what() << "\n";
@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "shuffle/allocator.hpp"
+
+
+namespace shuffle {
+
+namespace {
+
+// Settings and statistics only; nothing is published through them, so every access is
+// relaxed.
+std::atomic<bool> g_hugePagesEnabled{false};
+std::atomic<std::uint64_t> g_hugetlbAllocations{0};
+std::atomic<std::uint64_t> g_hugetlbBytes{0};
+std::atomic<std::uint64_t> g_madvisedAllocations{0};
+std::atomic<std::uint64_t> g_madvisedBytes{0};
+std::atomic<std::uint64_t> g_mappedAllocations{0};
+std::atomic<std::uint64_t> g_mappedBytes{0};
+
+// Every buffer that is currently mapped, since whether a buffer was mapped depends on the
+// setting at the time it was allocated, which may have changed since. The table is fixed
+// so that recording a buffer does not itself allocate; once it is full, further buffers
+// come from operator new.
+struct Mapping {
+    const void* address = nullptr;
+    std::size_t length = 0;
+};
+const std::size_t kMaxMappings = 256;
+std::mutex g_mappingsMutex;
+std::array<Mapping, kMaxMappings> g_mappings;
+
+// Records a mapped buffer; returns false if the table is full.
+bool recordMapping(const void* address, std::size_t length) {
+    std::lock_guard<std::mutex> lock(g_mappingsMutex);
+    for (Mapping& mapping : g_mappings) {
+        if (mapping.address == nullptr) {
+            mapping.address = address;
+            mapping.length = length;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Forgets a mapped buffer and returns its length, or 0 if `address` was not mapped.
+std::size_t forgetMapping(const void* address) {
+    std::lock_guard<std::mutex> lock(g_mappingsMutex);
+    for (Mapping& mapping : g_mappings) {
+        if (mapping.address == address) {
+            std::size_t length = mapping.length;
+            mapping = Mapping();
+            return length;
+        }
+    }
+    return 0;
+}
+
+std::size_t roundUp(std::size_t bytes, std::size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+#ifdef __linux__
+// Returns the default hugetlbfs page size from /proc/meminfo, which is what MAP_HUGETLB
+// uses without a size flag: 2 MiB on x86-64, but 1 GiB or 512 MiB on some systems.
+// Falls back to kHugePageSize.
+std::size_t hugetlbPageSize() {
+    static const std::size_t size = [] {
+        std::ifstream meminfo("/proc/meminfo");
+        std::string line;
+        while (std::getline(meminfo, line)) {
+            std::istringstream fields(line);
+            std::string key;
+            std::size_t kilobytes = 0;
+            if (fields >> key >> kilobytes && key == "Hugepagesize:" && kilobytes > 0) {
+                return kilobytes * 1024;
+            }
+        }
+        return kHugePageSize;
+    }();
+    return size;
+}
+#endif
+
+#ifdef __linux__
+// Maps `length` bytes at a kHugePageSize boundary by over-mapping and trimming.
+void* mapAligned(std::size_t length) {
+    std::size_t padded = length + kHugePageSize;
+    void* mapped = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(mapped);
+    std::uintptr_t aligned = (begin + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    if (aligned > begin) {
+        munmap(mapped, aligned - begin);
+    }
+    std::uintptr_t end = aligned + length;
+    if (begin + padded > end) {
+        munmap(reinterpret_cast<void*>(end), begin + padded - end);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+// Maps a buffer of at least `bytes` bytes and sets `length` to the length mapped.
+// Explicit huge pages are only tried for buffers of at least one such page, so that a
+// large default page size does not inflate small buffers.
+void* mapBuffer(std::size_t bytes, std::size_t& length) {
+#ifdef MAP_HUGETLB
+    std::size_t pageSize = hugetlbPageSize();
+    if (bytes >= pageSize) {
+        length = roundUp(bytes, pageSize);
+        void* explicitPages = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (explicitPages != MAP_FAILED) {
+            g_mappedAllocations.fetch_add(1, std::memory_order_relaxed);
+            g_mappedBytes.fetch_add(length, std::memory_order_relaxed);
+            g_hugetlbAllocations.fetch_add(1, std::memory_order_relaxed);
+            g_hugetlbBytes.fetch_add(length, std::memory_order_relaxed);
+            return explicitPages;
+        }
+    }
+#endif
+
+    length = roundUp(bytes, kHugePageSize);
+    g_mappedAllocations.fetch_add(1, std::memory_order_relaxed);
+    g_mappedBytes.fetch_add(length, std::memory_order_relaxed);
+    void* pointer = mapAligned(length);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if (madvise(pointer, length, MADV_HUGEPAGE) == 0) {
+        g_madvisedAllocations.fetch_add(1, std::memory_order_relaxed);
+        g_madvisedBytes.fetch_add(length, std::memory_order_relaxed);
+    }
+#endif
+    return pointer;
+}
+#endif
+
+/**
+ * @brief Queries sysconf() for the size of the given cache level, returning 0 if the C
+ * library does not know it.
+ */
+std::size_t queryCacheBytes(unsigned int level) {
+    long reported = -1;
+#ifdef __linux__
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    if (level == 2) {
+        reported = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    }
+#endif
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    if (level == 3) {
+        reported = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    }
+#endif
+#else
+    (void)level;
+#endif
+    return reported > 0 ? static_cast<std::size_t>(reported) : 0;
+}
+
+} // namespace
+
+
+void setHugePagesEnabled(bool enabled) {
+    g_hugePagesEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool hugePagesEnabled() {
+    return g_hugePagesEnabled.load(std::memory_order_relaxed);
+}
+
+HugePageStats hugePageStats() {
+    HugePageStats stats;
+    stats.hugetlbAllocations = g_hugetlbAllocations.load(std::memory_order_relaxed);
+    stats.hugetlbBytes = g_hugetlbBytes.load(std::memory_order_relaxed);
+    stats.madvisedAllocations = g_madvisedAllocations.load(std::memory_order_relaxed);
+    stats.madvisedBytes = g_madvisedBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+MappedBufferStats mappedBufferStats() {
+    MappedBufferStats stats;
+    stats.allocations = g_mappedAllocations.load(std::memory_order_relaxed);
+    stats.bytes = g_mappedBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::size_t detectedCacheBytes(unsigned int level) {
+    static const std::size_t level2 = queryCacheBytes(2);
+    static const std::size_t level3 = queryCacheBytes(3);
+    switch (level) {
+        case 2: return level2;
+        case 3: return level3;
+        default: return 0;
+    }
+}
+
+std::size_t hugePageBackedBytes(const void* data, std::size_t bytes) {
+    std::size_t backed = 0;
+#ifdef __linux__
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(data);
+    std::uintptr_t end = begin + bytes;
+
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool overlapping = false;
+    while (std::getline(smaps, line)) {
+        // A mapping starts with "start-end perms ...", with lowercase hexadecimal bounds.
+        std::size_t dash = line.find('-');
+        std::size_t space = line.find(' ');
+        if (dash != std::string::npos && space != std::string::npos && dash < space &&
+            line.find(':') > space) {
+            std::uintptr_t vmaBegin = std::stoull(line.substr(0, dash), nullptr, 16);
+            std::uintptr_t vmaEnd = std::stoull(line.substr(dash + 1, space - dash - 1), nullptr, 16);
+            overlapping = vmaBegin < end && begin < vmaEnd;
+            continue;
+        }
+        if (!overlapping) {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string key;
+        std::size_t kilobytes = 0;
+        fields >> key >> kilobytes;
+        if (key == "AnonHugePages:" || key == "Private_Hugetlb:" || key == "Shared_Hugetlb:") {
+            backed += kilobytes * 1024;
+        }
+    }
+#else
+    (void)data;
+    (void)bytes;
+#endif
+    // Mappings may extend beyond the buffer; never report more than the buffer itself.
+    return std::min(backed, bytes);
+}
+
+
+namespace detail {
+
+void* allocateBuffer(std::size_t bytes) {
+#ifdef __linux__
+    // Without huge pages, large buffers come from operator new like small ones, so the C
+    // library can reuse their memory instead of every call mapping and faulting it afresh.
+    if (bytes >= kHugePageSize && g_hugePagesEnabled.load(std::memory_order_relaxed)) {
+        std::size_t length = 0;
+        void* pointer = mapBuffer(bytes, length);
+        if (recordMapping(pointer, length)) {
+            return pointer;
+        }
+        munmap(pointer, length);
+    }
+#endif
+    return ::operator new(bytes, std::align_val_t(kBufferAlignment));
+}
+
+void deallocateBuffer(void* pointer, std::size_t bytes) noexcept {
+#ifdef __linux__
+    if (bytes >= kHugePageSize) {
+        std::size_t length = forgetMapping(pointer);
+        if (length > 0) {
+            munmap(pointer, length);
+            return;
+        }
+    }
+#endif
+    ::operator delete(pointer, std::align_val_t(kBufferAlignment));
+}
+
+} // namespace detail
+
+} // namespace shuffle
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "shuffle/numa.hpp"
+
+
+namespace shuffle {
+
+namespace {
+
+// Pages queried per move_pages() call, and the most pages sampled per buffer.
+const std::size_t kPlacementBatch = 4096;
+const std::size_t kMaxSampledPages = 65536;
+
+#ifdef __linux__
+// Parses a sysfs CPU list such as "0-3,8-11".
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        std::size_t dash = range.find('-');
+        int low = std::stoi(range.substr(0, dash));
+        int high = dash == std::string::npos ? low : std::stoi(range.substr(dash + 1));
+        for (int cpu = low; cpu <= high; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::vector<int> usableCpus() {
+    std::vector<int> cpus;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &mask)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+
+NumaTopology detectTopology() {
+    NumaTopology topology;
+    std::vector<int> usable = usableCpus();
+
+    std::vector<int> nodeIds;
+    if (DIR* dir = opendir("/sys/devices/system/node")) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                nodeIds.push_back(std::stoi(name.substr(4)));
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(nodeIds.begin(), nodeIds.end());
+
+    for (int node : nodeIds) {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        std::getline(in, list);
+        std::vector<int> cpus;
+        for (int cpu : parseCpuList(list)) {
+            if (std::find(usable.begin(), usable.end(), cpu) != usable.end()) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            topology.nodeIds.push_back(node);
+            topology.nodeCpus.push_back(cpus);
+        }
+    }
+
+    if (topology.nodeCpus.empty()) {
+        topology.nodeIds.push_back(0);
+        topology.nodeCpus.push_back(usable);
+    }
+    return topology;
+}
+#else
+NumaTopology detectTopology() {
+    NumaTopology topology;
+    topology.nodeIds.push_back(0);
+    topology.nodeCpus.push_back(std::vector<int>());
+    return topology;
+}
+#endif
+
+NumaTopology buildTopology() {
+    NumaTopology topology = detectTopology();
+    // Take the first CPU of every node, then the second of every node, and so on, so that
+    // any number of chunks is spread over all nodes before a node gets a second one.
+    std::size_t rounds = 0;
+    for (const std::vector<int>& cpus : topology.nodeCpus) {
+        rounds = std::max(rounds, cpus.size());
+    }
+    for (std::size_t round = 0; round < rounds; round++) {
+        for (int node = 0; node < topology.nodeCount(); node++) {
+            if (round < topology.nodeCpus[node].size()) {
+                topology.cpuOrder.push_back(topology.nodeCpus[node][round]);
+                topology.cpuNodes.push_back(topology.nodeIds[node]);
+            }
+        }
+    }
+    return topology;
+}
+
+} // namespace
+
+
+const NumaTopology& numaTopology() {
+    static const NumaTopology topology = buildTopology();
+    return topology;
+}
+
+int numaChunkNode(int chunk) {
+    const NumaTopology& topology = numaTopology();
+    if (topology.cpuOrder.empty()) {
+        return 0;
+    }
+    return topology.cpuNodes[static_cast<std::size_t>(chunk) % topology.cpuOrder.size()];
+}
+
+
+NumaThreadPin::NumaThreadPin(int chunk) : m_pinned(false) {
+#ifdef __linux__
+    const NumaTopology& topology = numaTopology();
+    if (topology.nodeCount() < 2 || topology.cpuOrder.empty()) {
+        return;
+    }
+
+    cpu_set_t previous;
+    CPU_ZERO(&previous);
+    if (sched_getaffinity(0, sizeof(previous), &previous) != 0) {
+        return;
+    }
+
+    cpu_set_t target;
+    CPU_ZERO(&target);
+    CPU_SET(topology.cpuOrder[static_cast<std::size_t>(chunk) % topology.cpuOrder.size()], &target);
+    if (sched_setaffinity(0, sizeof(target), &target) == 0) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&previous);
+        m_previousMask.assign(bytes, bytes + sizeof(previous));
+        m_pinned = true;
+    }
+#else
+    (void)chunk;
+#endif
+}
+
+NumaThreadPin::~NumaThreadPin() {
+#ifdef __linux__
+    if (m_pinned) {
+        cpu_set_t previous;
+        std::copy(m_previousMask.begin(), m_previousMask.end(), reinterpret_cast<unsigned char*>(&previous));
+        sched_setaffinity(0, sizeof(previous), &previous);
+    }
+#endif
+}
+
+
+NumaPlacement measureNumaPlacement(const void* data, std::size_t elementSize, std::size_t length, int chunks) {
+    NumaPlacement placement;
+    placement.nodes = numaTopology().nodeCount();
+#ifdef __linux__
+    std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(data);
+    std::uintptr_t end = begin + length * elementSize;
+    std::uintptr_t firstPage = begin / pageSize * pageSize;
+    placement.totalPages = (end - firstPage + pageSize - 1) / pageSize;
+    if (length == 0) {
+        return placement;
+    }
+
+    std::size_t stride = std::max<std::size_t>(1, (placement.totalPages + kMaxSampledPages - 1) / kMaxSampledPages);
+    std::vector<void*> pages;
+    std::vector<int> expected;
+    for (std::size_t page = 0; page < placement.totalPages; page += stride) {
+        std::uintptr_t address = std::max(firstPage + page * pageSize, begin);
+        std::size_t element = (address - begin) / elementSize;
+        int chunk = static_cast<int>(element * static_cast<std::size_t>(chunks) / length);
+        pages.push_back(reinterpret_cast<void*>(address));
+        expected.push_back(numaChunkNode(std::min(chunk, chunks - 1)));
+    }
+
+    std::vector<int> status(pages.size(), -1);
+    for (std::size_t batch = 0; batch < pages.size(); batch += kPlacementBatch) {
+        std::size_t count = std::min(kPlacementBatch, pages.size() - batch);
+        // With a null node list, move_pages() only reports the node of every page.
+        if (syscall(SYS_move_pages, 0, count, &pages[batch], nullptr, &status[batch], 0) != 0) {
+            std::fill(status.begin() + batch, status.begin() + batch + count, -1);
+        }
+    }
+
+    for (std::size_t i = 0; i < pages.size(); i++) {
+        if (status[i] < 0) {
+            placement.unknownPages++;
+        } else if (placement.nodes < 2 || status[i] == expected[i]) {
+            placement.localPages++;
+        } else {
+            placement.remotePages++;
+        }
+    }
+    placement.sampledPages = pages.size();
+#else
+    (void)data;
+    (void)elementSize;
+    (void)length;
+    (void)chunks;
+#endif
+    return placement;
+}
+
+} // namespace shuffle
@@ -0,0 +1,32 @@
+#include "shuffle/phase.hpp"
+
+
+namespace shuffle {
+
+namespace {
+
+thread_local PhaseObserver* t_phaseObserver = nullptr;
+
+} // namespace
+
+
+const char* phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::Init:     return "init";
+        case Phase::Shuffle:  return "shuffle";
+        case Phase::Merge:    return "merge";
+        case Phase::CopyBack: return "copy-back";
+        case Phase::Stats:    return "stats";
+        default:              return "other";
+    }
+}
+
+PhaseObserver* phaseObserver() {
+    return t_phaseObserver;
+}
+
+void setPhaseObserver(PhaseObserver* observer) {
+    t_phaseObserver = observer;
+}
+
+} // namespace shuffle
@@ -0,0 +1,217 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "shuffle/thread_pool.hpp"
+
+
+namespace shuffle {
+
+namespace {
+
+// The pool and participant index of the calling worker thread.
+thread_local const WorkStealingPool* t_pool = nullptr;
+thread_local std::size_t t_participant = 0;
+
+// How long an idle worker sleeps before looking for work again, in case a wake-up was missed.
+const std::chrono::milliseconds kIdleRecheck(10);
+
+std::uint64_t elapsedNanoseconds(std::chrono::steady_clock::time_point since) {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - since).count());
+}
+
+} // namespace
+
+
+WorkStealingPool::WorkStealingPool(unsigned int workers) {
+    // Slot 0 is the injection queue shared by threads outside the pool.
+    for (unsigned int i = 0; i <= workers; i++) {
+        m_participants.push_back(std::make_unique<Participant>());
+    }
+    for (unsigned int i = 1; i <= workers; i++) {
+        m_threads.emplace_back(&WorkStealingPool::workerLoop, this, static_cast<std::size_t>(i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping.store(true);
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+unsigned int WorkStealingPool::workers() const {
+    return static_cast<unsigned int>(m_threads.size());
+}
+
+std::vector<WorkerStats> WorkStealingPool::stats() const {
+    std::vector<WorkerStats> result;
+    for (const std::unique_ptr<Participant>& participant : m_participants) {
+        WorkerStats stats;
+        stats.tasksExecuted = participant->tasksExecuted.load();
+        stats.tasksStolen = participant->tasksStolen.load();
+        stats.failedSteals = participant->failedSteals.load();
+        stats.idleNanoseconds = participant->idleNanoseconds.load();
+        result.push_back(stats);
+    }
+    return result;
+}
+
+void WorkStealingPool::resetStats() {
+    for (std::unique_ptr<Participant>& participant : m_participants) {
+        participant->tasksExecuted.store(0);
+        participant->tasksStolen.store(0);
+        participant->failedSteals.store(0);
+        participant->idleNanoseconds.store(0);
+    }
+}
+
+std::size_t WorkStealingPool::currentParticipant() const {
+    return t_pool == this ? t_participant : 0;
+}
+
+void WorkStealingPool::submit(Task task) {
+    Participant& target = *m_participants[currentParticipant()];
+    {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        target.tasks.push_back(std::move(task));
+    }
+    m_queued.fetch_add(1);
+
+    // Pairs with the sleeper's check of m_queued; both sides use sequentially consistent
+    // atomics, so either the sleeper sees the task or this thread sees the sleeper.
+    if (m_sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wake.notify_one();
+    }
+}
+
+bool WorkStealingPool::popLocal(std::size_t self, Task& task) {
+    Participant& participant = *m_participants[self];
+    std::lock_guard<std::mutex> lock(participant.mutex);
+    if (participant.tasks.empty()) {
+        return false;
+    }
+    // Take the newest task, also from the injection queue. A waiting thread runs the task
+    // on its own stack, and the newest one is the smallest subtree it spawned last, so the
+    // nesting stays within the depth of the task tree. Serving the oldest task instead
+    // would nest once per queued task and overflow the stack on large inputs.
+    task = std::move(participant.tasks.back());
+    participant.tasks.pop_back();
+    m_queued.fetch_sub(1);
+    return true;
+}
+
+bool WorkStealingPool::steal(std::size_t self, Task& task) {
+    std::size_t count = m_participants.size();
+    for (std::size_t offset = 1; offset < count; offset++) {
+        std::size_t victim = (self + offset) % count;
+        Participant& participant = *m_participants[victim];
+        std::lock_guard<std::mutex> lock(participant.mutex);
+        if (participant.tasks.empty()) {
+            continue;
+        }
+        task = std::move(participant.tasks.front());
+        participant.tasks.pop_front();
+        m_queued.fetch_sub(1);
+        m_participants[self]->tasksStolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    m_participants[self]->failedSteals.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool WorkStealingPool::runOne() {
+    std::size_t self = currentParticipant();
+    Task task;
+    if (!popLocal(self, task) && !steal(self, task)) {
+        return false;
+    }
+    task();
+    m_participants[self]->tasksExecuted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void WorkStealingPool::workerLoop(std::size_t self) {
+    t_pool = this;
+    t_participant = self;
+
+    while (!m_stopping.load()) {
+        if (runOne()) {
+            continue;
+        }
+
+        std::chrono::steady_clock::time_point idleSince = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepers.fetch_add(1);
+            m_wake.wait_for(lock, kIdleRecheck, [this] {
+                return m_stopping.load() || m_queued.load() > 0;
+            });
+            m_sleepers.fetch_sub(1);
+        }
+        m_participants[self]->idleNanoseconds.fetch_add(elapsedNanoseconds(idleSince), std::memory_order_relaxed);
+    }
+}
+
+
+void TaskGroup::wait() {
+    drain();
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        std::swap(error, m_error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskGroup::recordException(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    if (!m_error) {
+        m_error = error;
+    }
+}
+
+void TaskGroup::drain() {
+    std::size_t self = m_pool.currentParticipant();
+    std::chrono::steady_clock::time_point idleSince;
+    bool idle = false;
+
+    while (m_pending.load() > 0) {
+        if (m_pool.runOne()) {
+            if (idle) {
+                m_pool.m_participants[self]->idleNanoseconds.fetch_add(
+                    elapsedNanoseconds(idleSince), std::memory_order_relaxed);
+                idle = false;
+            }
+            continue;
+        }
+        // The remaining tasks of this group are running elsewhere.
+        if (!idle) {
+            idleSince = std::chrono::steady_clock::now();
+            idle = true;
+        }
+        std::this_thread::yield();
+    }
+
+    if (idle) {
+        m_pool.m_participants[self]->idleNanoseconds.fetch_add(
+            elapsedNanoseconds(idleSince), std::memory_order_relaxed);
+    }
+}
+
+} // namespace shuffle
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "util/benchmark.hpp"
+
+
+namespace {
+
+// Nearest-rank percentile of sorted samples.
+std::uint64_t percentile(const std::vector<std::uint64_t>& sorted, double p) {
+    std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+// Keeps the compiler from discarding the shuffled output.
+volatile unsigned int g_sink = 0;
+
+} // namespace
+
+
+BenchmarkResult runBenchmark(
+    NumbersShuffler& shuffler,
+    ShuffleFunc func,
+    const std::string& funcName,
+    unsigned int length,
+    unsigned int warmup,
+    unsigned int repetitions
+) {
+    if (repetitions == 0) {
+        throw std::runtime_error("Error: --repetitions must be a positive integer.");
+    }
+
+    for (unsigned int i = 0; i < warmup; ++i) {
+        Permutation perm = (shuffler.*func)(length);
+        g_sink = g_sink + perm[0];
+    }
+
+    BenchmarkResult result;
+    result.algorithm = funcName;
+    result.length = length;
+    result.warmup = warmup;
+    result.repetitions = repetitions;
+    result.samples.reserve(repetitions);
+    MemoryMonitor monitor;
+    for (unsigned int i = 0; i < repetitions; ++i) {
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        Permutation perm = (shuffler.*func)(length);
+        std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+        result.samples.push_back(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count()));
+        g_sink = g_sink + perm[0];
+    }
+
+    result.memory = monitor.stop();
+
+    std::sort(result.samples.begin(), result.samples.end());
+    result.min = result.samples.front();
+    result.p50 = percentile(result.samples, 50.0);
+    result.p90 = percentile(result.samples, 90.0);
+    result.p99 = percentile(result.samples, 99.0);
+    result.max = result.samples.back();
+    result.mean = std::accumulate(result.samples.begin(), result.samples.end(), 0.0) / repetitions;
+    result.throughput = result.p50 > 0 ? length * 1e9 / static_cast<double>(result.p50) : 0.0;
+    return result;
+}
+
+
+void printBenchmark(const BenchmarkResult& result) {
+    std::cout << "Benchmarking " << result.algorithm
+              << " with permutation length = " << result.length
+              << " (" << result.warmup << " warmup, " << result.repetitions << " repetitions)\n\n";
+    std::cout << std::setw(15) << "Statistic" << std::setw(20) << "Latency (ns)" << "\n";
+    std::cout << std::setw(15) << "min" << std::setw(20) << result.min << "\n";
+    std::cout << std::setw(15) << "p50" << std::setw(20) << result.p50 << "\n";
+    std::cout << std::setw(15) << "p90" << std::setw(20) << result.p90 << "\n";
+    std::cout << std::setw(15) << "p99" << std::setw(20) << result.p99 << "\n";
+    std::cout << std::setw(15) << "max" << std::setw(20) << result.max << "\n";
+    std::cout << std::setw(15) << "mean" << std::setw(20) << std::fixed << std::setprecision(0) << result.mean << "\n";
+    std::cout << "\nThroughput: " << std::setprecision(0) << result.throughput << " elements/s at p50\n";
+    printMemoryUsage(result.memory, result.repetitions);
+    std::cout << std::string(80, '=') << "\n\n";
+}
+
+
+void writeBenchmark(const BenchmarkResult& result, const std::string& path, const std::string& format) {
+    if (format == "json") {
+        std::ofstream out(path);
+        if (!out) {
+            throw std::runtime_error("Error: cannot write benchmark output: " + path);
+        }
+        out << "{\n"
+            << "  \"algorithm\": \"" << result.algorithm << "\",\n"
+            << "  \"length\": " << result.length << ",\n"
+            << "  \"warmup\": " << result.warmup << ",\n"
+            << "  \"repetitions\": " << result.repetitions << ",\n"
+            << "  \"unit\": \"ns\",\n"
+            << "  \"min\": " << result.min << ",\n"
+            << "  \"p50\": " << result.p50 << ",\n"
+            << "  \"p90\": " << result.p90 << ",\n"
+            << "  \"p99\": " << result.p99 << ",\n"
+            << "  \"max\": " << result.max << ",\n"
+            << "  \"mean\": " << std::fixed << std::setprecision(1) << result.mean << ",\n"
+            << "  \"throughput_elements_per_second\": " << result.throughput << ",\n"
+            << "  \"allocations\": " << result.memory.allocations << ",\n"
+            << "  \"allocated_bytes\": " << result.memory.allocatedBytes << ",\n"
+            << "  \"peak_rss_bytes\": " << result.memory.peakResidentBytes << "\n"
+            << "}\n";
+    } else if (format == "csv") {
+        bool isNew = !std::ifstream(path).good();
+        std::ofstream out(path, std::ios::app);
+        if (!out) {
+            throw std::runtime_error("Error: cannot write benchmark output: " + path);
+        }
+        if (isNew) {
+            out << "algorithm,length,warmup,repetitions,min_ns,p50_ns,p90_ns,p99_ns,max_ns,mean_ns,"
+                << "throughput_elements_per_second,allocations,allocated_bytes,peak_rss_bytes\n";
+        }
+        out << result.algorithm << "," << result.length << "," << result.warmup << ","
+            << result.repetitions << "," << result.min << "," << result.p50 << ","
+            << result.p90 << "," << result.p99 << "," << result.max << ","
+            << std::fixed << std::setprecision(1) << result.mean << "," << result.throughput << ","
+            << result.memory.allocations << "," << result.memory.allocatedBytes << ","
+            << result.memory.peakResidentBytes << "\n";
+    } else {
+        throw std::runtime_error("Error: unknown output format: " + format);
+    }
+}
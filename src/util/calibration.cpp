@@ -0,0 +1,259 @@
+#include <omp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "shuffle/lehmer.hpp"
+#include "util/calibration.hpp"
+
+
+const char* const kDefaultProfilePath = "shuffle_profile.txt";
+
+namespace {
+
+const char* const kProfileHeader = "# shuffle calibration profile v1";
+const unsigned int kMinCalibrationLength = 16;
+// Every grid point is repeated until this much time was spent, but at least kMinRepetitions times.
+const double kMinSampleNanoseconds = 20e6;
+const unsigned int kMinRepetitions = 3;
+// Algorithms slower than this per call are not measured at larger lengths (e.g. the O(n^2) ones),
+// unless they were the fastest at some thread count. Calls this slow are made only once.
+const double kMaxCallNanoseconds = 250e6;
+
+
+double bestCallNanoseconds(NumbersShuffler& shuffler, ShuffleFunc func, unsigned int length) {
+    double best = std::numeric_limits<double>::max();
+    double total = 0.0;
+    for (unsigned int rep = 0; rep < kMinRepetitions || total < kMinSampleNanoseconds; ++rep) {
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        Permutation perm = (shuffler.*func)(length);
+        std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double, std::nano>(endTime - startTime).count();
+        best = std::min(best, elapsed);
+        total += elapsed;
+        if (elapsed > kMaxCallNanoseconds) {
+            break;
+        }
+    }
+    return best;
+}
+
+std::vector<unsigned int> calibrationLengths(unsigned int maxLength) {
+    std::vector<unsigned int> lengths;
+    for (unsigned long length = kMinCalibrationLength; length < maxLength; length *= 4) {
+        lengths.push_back(static_cast<unsigned int>(length));
+    }
+    lengths.push_back(maxLength);
+    return lengths;
+}
+
+std::vector<int> calibrationThreadCounts() {
+    std::vector<int> threadCounts;
+    int maxThreads = omp_get_max_threads();
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+    return threadCounts;
+}
+
+void saveProfile(const std::vector<CalibrationEntry>& entries, const std::string& profilePath) {
+    std::ofstream out(profilePath);
+    if (!out) {
+        throw std::runtime_error("Error: cannot write calibration profile: " + profilePath);
+    }
+    out << kProfileHeader << "\n";
+    out << "# length threads algorithm nanoseconds\n";
+    for (const CalibrationEntry& entry : entries) {
+        out << entry.length << " " << entry.threads << " " << entry.algorithm << " "
+            << std::fixed << std::setprecision(0) << entry.nanoseconds << "\n";
+    }
+}
+
+// Distance between two lengths on a logarithmic scale.
+double lengthDistance(unsigned int a, unsigned int b) {
+    return std::fabs(std::log(static_cast<double>(a)) - std::log(static_cast<double>(b)));
+}
+
+} // namespace
+
+
+void runCalibration(NumbersShuffler& shuffler, unsigned int maxLength, const std::string& profilePath) {
+    std::vector<Algorithm> candidates;
+    for (const Algorithm& algorithm : availableAlgorithms()) {
+        if (algorithm.unbiased) {
+            candidates.push_back(algorithm);
+        }
+    }
+
+    std::vector<unsigned int> lengths = calibrationLengths(maxLength);
+    std::vector<int> threadCounts = calibrationThreadCounts();
+    int originalThreads = omp_get_max_threads();
+
+    std::cout << "Calibrating " << candidates.size() << " unbiased algorithms over "
+              << lengths.size() << " lengths and " << threadCounts.size() << " thread counts\n\n";
+    std::cout << std::setw(12) << "Length"
+              << std::setw(10) << "Threads"
+              << std::setw(26) << "Fastest"
+              << std::setw(18) << "Time (ns)" << "\n";
+
+    std::vector<CalibrationEntry> entries;
+    std::vector<bool> tooSlow(candidates.size(), false);
+    for (unsigned int length : lengths) {
+        // Sequential algorithms are measured once per length and reused for every thread count.
+        std::vector<double> sequentialTimes(candidates.size(), 0.0);
+        for (unsigned int i = 0; i < candidates.size(); ++i) {
+            // Beyond its single-draw range lehmerShuffle only repeats durstenfeldShuffle.
+            if (candidates[i].func == &NumbersShuffler::lehmerShuffle && length > shuffle::kLehmerMaxLength) {
+                tooSlow[i] = true;
+            }
+            if (!candidates[i].parallel && !tooSlow[i]) {
+                sequentialTimes[i] = bestCallNanoseconds(shuffler, candidates[i].func, length);
+            }
+        }
+
+        // Algorithms that won at some thread count keep being measured however slow they get,
+        // so that the profile covers every length.
+        std::vector<std::string> winners;
+        for (int threads : threadCounts) {
+            omp_set_num_threads(threads);
+            const CalibrationEntry* fastest = nullptr;
+            std::size_t firstEntry = entries.size();
+            for (unsigned int i = 0; i < candidates.size(); ++i) {
+                if (tooSlow[i]) {
+                    continue;
+                }
+                double nanoseconds = candidates[i].parallel
+                    ? bestCallNanoseconds(shuffler, candidates[i].func, length)
+                    : sequentialTimes[i];
+                entries.push_back({length, threads, candidates[i].name, nanoseconds});
+            }
+            for (std::size_t e = firstEntry; e < entries.size(); ++e) {
+                if (fastest == nullptr || entries[e].nanoseconds < fastest->nanoseconds) {
+                    fastest = &entries[e];
+                }
+            }
+            if (fastest == nullptr) {
+                continue;
+            }
+            winners.push_back(fastest->algorithm);
+            std::cout << std::setw(12) << length
+                      << std::setw(10) << threads
+                      << std::setw(26) << fastest->algorithm
+                      << std::setw(18) << std::fixed << std::setprecision(0) << fastest->nanoseconds << "\n";
+        }
+
+        for (std::size_t e = 0; e < entries.size(); ++e) {
+            if (entries[e].length != length || entries[e].nanoseconds <= kMaxCallNanoseconds ||
+                std::find(winners.begin(), winners.end(), entries[e].algorithm) != winners.end()) {
+                continue;
+            }
+            for (unsigned int i = 0; i < candidates.size(); ++i) {
+                if (candidates[i].name == entries[e].algorithm) {
+                    tooSlow[i] = true;
+                }
+            }
+        }
+    }
+    omp_set_num_threads(originalThreads);
+
+    saveProfile(entries, profilePath);
+    std::cout << "\nProfile saved to " << profilePath << "\n";
+    std::cout << std::string(80, '=') << "\n\n";
+}
+
+
+std::vector<CalibrationEntry> loadProfile(const std::string& profilePath) {
+    std::ifstream in(profilePath);
+    if (!in) {
+        throw std::runtime_error("Error: cannot open calibration profile: " + profilePath);
+    }
+
+    std::string line;
+    if (!std::getline(in, line) || line != kProfileHeader) {
+        throw std::runtime_error("Error: not a calibration profile: " + profilePath);
+    }
+
+    std::vector<CalibrationEntry> entries;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        CalibrationEntry entry;
+        if (!(fields >> entry.length >> entry.threads >> entry.algorithm >> entry.nanoseconds)) {
+            throw std::runtime_error("Error: malformed line in calibration profile: " + line);
+        }
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+
+std::pair<std::string, ShuffleFunc> selectAutoAlgorithm(const std::string& profilePath, unsigned int length) {
+    std::vector<CalibrationEntry> entries;
+    try {
+        entries = loadProfile(profilePath);
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n"
+                  << "Warning: run --mode calibrate first; using durstenfeldShuffle.\n";
+        return selectAlgorithm("durstenfeldShuffle");
+    }
+
+    // Prefer the largest calibrated thread count that does not exceed the current one.
+    int currentThreads = omp_get_max_threads();
+    int threads = 0;
+    for (const CalibrationEntry& entry : entries) {
+        if (entry.threads <= currentThreads && entry.threads > threads) {
+            threads = entry.threads;
+        }
+    }
+
+    // Then the calibrated length closest to the requested one.
+    const CalibrationEntry* closest = nullptr;
+    for (const CalibrationEntry& entry : entries) {
+        if (entry.threads == threads &&
+            (closest == nullptr || lengthDistance(entry.length, length) < lengthDistance(closest->length, length))) {
+            closest = &entry;
+        }
+    }
+    if (closest == nullptr) {
+        std::cerr << "Warning: calibration profile has no usable entries; using durstenfeldShuffle.\n";
+        return selectAlgorithm("durstenfeldShuffle");
+    }
+
+    // Finally the fastest unbiased algorithm at that grid point.
+    std::vector<Algorithm> algorithms = availableAlgorithms();
+    const CalibrationEntry* fastest = nullptr;
+    for (const CalibrationEntry& entry : entries) {
+        if (entry.threads != threads || entry.length != closest->length) {
+            continue;
+        }
+        bool known = std::any_of(algorithms.begin(), algorithms.end(),
+            [&entry](const Algorithm& algorithm) {
+                return algorithm.unbiased && algorithm.name == entry.algorithm;
+            }
+        );
+        if (known && (fastest == nullptr || entry.nanoseconds < fastest->nanoseconds)) {
+            fastest = &entry;
+        }
+    }
+    if (fastest == nullptr) {
+        std::cerr << "Warning: calibration profile names no known algorithm; using durstenfeldShuffle.\n";
+        return selectAlgorithm("durstenfeldShuffle");
+    }
+
+    std::cout << "Auto-selected " << fastest->algorithm << " (calibrated at length "
+              << fastest->length << " with " << fastest->threads << " threads)\n";
+    return selectAlgorithm(fastest->algorithm);
+}
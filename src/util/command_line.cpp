@@ -1,24 +1,48 @@
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <stdexcept>
 #include <string>
 #include <cstdlib>
 
+#include "util/calibration.hpp"
 #include "util/command_line.hpp"
 
 void printUsage(const std::string &programName) {
     std::cerr << "Usage:\n"
               << "  " << programName
-              << " --mode <generate|stats> --n <permutation length> --algorithm <algorithm name or index> [--iterations <iterations>]\n\n"
+              << " --mode <generate|stats|bench|stress|records|calibrate> --n <permutation length> --algorithm <algorithm name, index or auto> [--iterations <iterations>] [--profile <path>] [--perf] [--hugepages]\n"
+              << "       [--warmup <calls>] [--repetitions <calls>] [--output <path>] [--format <json|csv>]\n"
+              << "       [--threads <count>] [--grain <elements>] [--runtime <openmp|pool>] [--count <permutations>]\n\n"
               << "Examples:\n"
               << "  " << programName << " --mode generate --n 100 --algorithm 6\n"
-              << "  " << programName << " --mode stats --n 1000 --algorithm fisherYatesShuffle --iterations 100\n";
+              << "  " << programName << " --mode stats --n 1000 --algorithm fisherYatesShuffle --iterations 100\n"
+              << "  " << programName << " --mode bench --n 1000000 --algorithm 6 --repetitions 50 --output bench.json\n"
+              << "  " << programName << " --mode stress --n 1000 --algorithm durstenfeldShuffle --iterations 10000 --threads 16\n"
+              << "  " << programName << " --mode records --n 1000000 --iterations 5\n"
+              << "  " << programName << " --mode generate --n 52 --algorithm durstenfeldShuffle --count 1000000 > decks.bin\n"
+              << "  " << programName << " --mode stats --n 1000 --algorithm parallelMergeShuffle --iterations 10000 --runtime pool --threads 8\n"
+              << "  " << programName << " --mode calibrate --n 16777216\n"
+              << "  " << programName << " --mode generate --n 100000 --algorithm auto\n";
 }
 
 ProgramOptions parseArguments(int argc, char* argv[]) {
     ProgramOptions options;
+    options.permutationLength = 0;
     options.iterations = 1;
+    options.profilePath = kDefaultProfilePath;
+    options.perf = false;
+    options.hugePages = false;
+    options.warmup = 3;
+    options.repetitions = 100;
+    options.outputFormat = "json";
+    options.threads = 0;
+    options.grain = 0;
+    options.runtime = "openmp";
+    options.stream = false;
+    options.count = 0;
 
-    if (argc < 7) {
+    if (argc < 2) {
         throw std::runtime_error("Insufficient arguments provided.");
     }
     for (int i = 1; i < argc; i++) {
@@ -59,10 +83,116 @@ ProgramOptions parseArguments(int argc, char* argv[]) {
                 throw std::runtime_error("Error: --iterations requires an argument.");
             }
         }
+        else if (arg == "--profile") {
+            if (i + 1 < argc) {
+                options.profilePath = argv[++i];
+            } else {
+                throw std::runtime_error("Error: --profile requires an argument.");
+            }
+        }
+        else if (arg == "--warmup") {
+            if (i + 1 < argc) {
+                try {
+                    options.warmup = static_cast<unsigned int>(std::stoul(argv[++i]));
+                } catch (const std::exception &) {
+                    throw std::runtime_error("Error: invalid value for --warmup.");
+                }
+            } else {
+                throw std::runtime_error("Error: --warmup requires an argument.");
+            }
+        }
+        else if (arg == "--repetitions") {
+            if (i + 1 < argc) {
+                try {
+                    options.repetitions = static_cast<unsigned int>(std::stoul(argv[++i]));
+                } catch (const std::exception &) {
+                    throw std::runtime_error("Error: invalid value for --repetitions.");
+                }
+            } else {
+                throw std::runtime_error("Error: --repetitions requires an argument.");
+            }
+        }
+        else if (arg == "--output") {
+            if (i + 1 < argc) {
+                options.outputPath = argv[++i];
+            } else {
+                throw std::runtime_error("Error: --output requires an argument.");
+            }
+        }
+        else if (arg == "--format") {
+            if (i + 1 < argc) {
+                options.outputFormat = argv[++i];
+            } else {
+                throw std::runtime_error("Error: --format requires an argument.");
+            }
+            if (options.outputFormat != "json" && options.outputFormat != "csv") {
+                throw std::runtime_error("Error: --format must be json or csv.");
+            }
+        }
+        else if (arg == "--threads") {
+            if (i + 1 < argc) {
+                try {
+                    options.threads = static_cast<unsigned int>(std::stoul(argv[++i]));
+                } catch (const std::exception &) {
+                    throw std::runtime_error("Error: invalid value for --threads.");
+                }
+            } else {
+                throw std::runtime_error("Error: --threads requires an argument.");
+            }
+        }
+        else if (arg == "--grain") {
+            if (i + 1 < argc) {
+                try {
+                    options.grain = static_cast<std::size_t>(std::stoull(argv[++i]));
+                } catch (const std::exception &) {
+                    throw std::runtime_error("Error: invalid value for --grain.");
+                }
+            } else {
+                throw std::runtime_error("Error: --grain requires an argument.");
+            }
+        }
+        else if (arg == "--runtime") {
+            if (i + 1 < argc) {
+                options.runtime = argv[++i];
+            } else {
+                throw std::runtime_error("Error: --runtime requires an argument.");
+            }
+            if (options.runtime != "openmp" && options.runtime != "pool") {
+                throw std::runtime_error("Error: --runtime must be openmp or pool.");
+            }
+        }
+        else if (arg == "--count") {
+            if (i + 1 < argc) {
+                try {
+                    options.count = static_cast<std::uint64_t>(std::stoull(argv[++i]));
+                } catch (const std::exception &) {
+                    throw std::runtime_error("Error: invalid value for --count.");
+                }
+                options.stream = true;
+            } else {
+                throw std::runtime_error("Error: --count requires an argument.");
+            }
+        }
+        else if (arg == "--perf") {
+            options.perf = true;
+        }
+        else if (arg == "--hugepages") {
+            options.hugePages = true;
+        }
         else {
             throw std::runtime_error("Unknown argument: " + arg);
         }
     }
+    if (options.mode.empty()) {
+        throw std::runtime_error("Error: --mode is required.");
+    }
+    if (options.algorithm.empty() && (options.mode == "generate" || options.mode == "stats" ||
+                                     options.mode == "bench" || options.mode == "stress")) {
+        throw std::runtime_error("Error: --algorithm is required in " + options.mode + " mode.");
+    }
+    if (options.stream && options.mode != "generate") {
+        throw std::runtime_error("Error: --count is only supported in generate mode.");
+    }
     if (options.permutationLength == 0) {
         throw std::runtime_error("Error: permutation length (--n) must be a positive integer.");
     }
@@ -1,27 +1,48 @@
+#include <omp.h>
+
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 #include <utility>
 
+#include "shuffle/allocator.hpp"
+#include "shuffle/numa.hpp"
 #include "util/helpers.hpp"
 
 
 const unsigned int kMaxElementsToShow = 20;
 const unsigned int kThresholdForTruncatedOutput = 100;
+// Permutations of at least this many elements (1 MiB) get a NUMA placement report.
+const unsigned int kMinLengthForNumaReport = 262144;
 
 
-std::pair<std::string, ShuffleFunc> selectAlgorithm(const std::string &algorithmArg) {
+std::vector<Algorithm> availableAlgorithms() {
     std::vector<Algorithm> algorithms;
-    algorithms.push_back({"biasedNaiveShuffle",       &NumbersShuffler::biasedNaiveShuffle});
-    algorithms.push_back({"naiveShuffle",             &NumbersShuffler::naiveShuffle});
-    algorithms.push_back({"biasedFisherYatesShuffle", &NumbersShuffler::biasedFisherYatesShuffle});
-    algorithms.push_back({"fisherYatesShuffle",       &NumbersShuffler::fisherYatesShuffle});
-    algorithms.push_back({"biasedDurstenfeldShuffle", &NumbersShuffler::biasedDurstenfeldShuffle});
-    algorithms.push_back({"durstenfeldShuffle",       &NumbersShuffler::durstenfeldShuffle});
-    algorithms.push_back({"randomShuffle",            &NumbersShuffler::randomShuffle});
-    algorithms.push_back({"mergeShuffle",             &NumbersShuffler::mergeShuffle});
-    algorithms.push_back({"parallelMergeShuffle",     &NumbersShuffler::parallelMergeShuffle});
+    algorithms.push_back({"biasedNaiveShuffle",       &NumbersShuffler::biasedNaiveShuffle,       false, false});
+    algorithms.push_back({"naiveShuffle",             &NumbersShuffler::naiveShuffle,             false, false});
+    algorithms.push_back({"biasedFisherYatesShuffle", &NumbersShuffler::biasedFisherYatesShuffle, false, false});
+    algorithms.push_back({"fisherYatesShuffle",       &NumbersShuffler::fisherYatesShuffle,       true,  false});
+    algorithms.push_back({"biasedDurstenfeldShuffle", &NumbersShuffler::biasedDurstenfeldShuffle, false, false});
+    algorithms.push_back({"durstenfeldShuffle",       &NumbersShuffler::durstenfeldShuffle,       true,  false});
+    // Ties between the 32-bit sort keys keep their original order, so it is not exactly uniform.
+    algorithms.push_back({"randomShuffle",            &NumbersShuffler::randomShuffle,            false, false});
+    algorithms.push_back({"mergeShuffle",             &NumbersShuffler::mergeShuffle,             true,  false});
+    algorithms.push_back({"parallelMergeShuffle",     &NumbersShuffler::parallelMergeShuffle,     true,  true});
+    algorithms.push_back({"numaParallelMergeShuffle", &NumbersShuffler::numaParallelMergeShuffle, true,  true});
+    // Single draw for up to 20 elements; durstenfeldShuffle beyond that.
+    algorithms.push_back({"lehmerShuffle",            &NumbersShuffler::lehmerShuffle,            true,  false});
+    algorithms.push_back({"insideOutShuffle",         &NumbersShuffler::insideOutShuffle,         true,  false});
+    algorithms.push_back({"insideOutMergeShuffle",    &NumbersShuffler::insideOutMergeShuffle,    true,  false});
+    algorithms.push_back({"raoSandeliusShuffle",      &NumbersShuffler::raoSandeliusShuffle,      true,  false});
+    return algorithms;
+}
+
+
+std::pair<std::string, ShuffleFunc> selectAlgorithm(const std::string &algorithmArg) {
+    std::vector<Algorithm> algorithms = availableAlgorithms();
 
     unsigned int count = static_cast<unsigned int>(algorithms.size());
     try {
@@ -45,7 +66,28 @@ std::pair<std::string, ShuffleFunc> selectAlgorithm(const std::string &algorithm
 }
 
 
-void printPermutation(const std::vector<unsigned int> &perm, const std::string &funcName) {
+void printPoolStats(const shuffle::WorkStealingPool &pool) {
+    std::vector<shuffle::WorkerStats> stats = pool.stats();
+
+    std::cout << "Work-stealing pool (" << pool.workers() << " workers + calling threads):\n";
+    std::cout << std::setw(10) << "Worker"
+              << std::setw(14) << "Tasks"
+              << std::setw(14) << "Stolen"
+              << std::setw(16) << "Failed steals"
+              << std::setw(14) << "Idle (ms)" << "\n";
+    for (std::size_t i = 0; i < stats.size(); i++) {
+        std::cout << std::setw(10) << (i == 0 ? std::string("caller") : std::to_string(i))
+                  << std::setw(14) << stats[i].tasksExecuted
+                  << std::setw(14) << stats[i].tasksStolen
+                  << std::setw(16) << stats[i].failedSteals
+                  << std::setw(14) << std::fixed << std::setprecision(2)
+                  << stats[i].idleNanoseconds / 1e6 << "\n";
+    }
+    std::cout << std::string(80, '=') << "\n\n";
+}
+
+
+void printPermutation(const Permutation &perm, const std::string &funcName) {
     unsigned int length = static_cast<unsigned int>(perm.size());
     std::cout << "\nShuffled list (" << length << " elements) using " << funcName << ":\n";
 
@@ -74,6 +116,54 @@ void generateShuffledList(
     const std::string &funcName,
     unsigned int length
 ) {
-    std::vector<unsigned int> perm = (shuffler.*func)(length);
+    Permutation perm = (shuffler.*func)(length);
     printPermutation(perm, funcName);
+    if (length >= kMinLengthForNumaReport) {
+        printNumaPlacement(perm);
+    }
+    if (shuffle::hugePagesEnabled()) {
+        printHugePageReport(&perm);
+    }
+}
+
+
+void printHugePageReport(const Permutation *perm) {
+    const double mebibyte = 1024.0 * 1024.0;
+    shuffle::HugePageStats stats = shuffle::hugePageStats();
+
+    std::string transparentMode = "unknown";
+    std::ifstream thpSetting("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::getline(thpSetting, transparentMode);
+
+    std::cout << "Huge pages (transparent huge pages: " << transparentMode << "):\n"
+              << std::fixed << std::setprecision(1)
+              << "  hugetlbfs buffers: " << stats.hugetlbAllocations
+              << " (" << stats.hugetlbBytes / mebibyte << " MiB)\n"
+              << "  MADV_HUGEPAGE buffers: " << stats.madvisedAllocations
+              << " (" << stats.madvisedBytes / mebibyte << " MiB)\n";
+    if (perm != nullptr) {
+        std::size_t bytes = perm->size() * sizeof(unsigned int);
+        std::size_t backed = shuffle::hugePageBackedBytes(perm->data(), bytes);
+        std::cout << "  permutation backed by huge pages: " << backed / mebibyte << " of "
+                  << bytes / mebibyte << " MiB\n";
+    }
+    std::cout << std::string(80, '=') << "\n\n";
+}
+
+
+void printNumaPlacement(const Permutation &perm) {
+    int chunks = omp_get_max_threads();
+    shuffle::NumaPlacement placement = shuffle::measureNumaPlacement(
+        perm.data(), sizeof(unsigned int), perm.size(), chunks
+    );
+    double sampled = placement.sampledPages > 0 ? static_cast<double>(placement.sampledPages) : 1.0;
+
+    std::cout << "NUMA placement (" << placement.nodes << " node" << (placement.nodes == 1 ? "" : "s")
+              << ", " << chunks << " chunks, " << placement.sampledPages << " of "
+              << placement.totalPages << " pages sampled): "
+              << std::fixed << std::setprecision(1)
+              << 100.0 * placement.localPages / sampled << "% local, "
+              << 100.0 * placement.remotePages / sampled << "% remote, "
+              << 100.0 * placement.unknownPages / sampled << "% unknown\n";
+    std::cout << std::string(80, '=') << "\n\n";
 }
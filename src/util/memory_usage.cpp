@@ -0,0 +1,207 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "shuffle/allocator.hpp"
+#include "util/memory_usage.hpp"
+
+
+namespace {
+
+std::atomic<std::uint64_t> g_heapAllocations{0};
+std::atomic<std::uint64_t> g_heapBytes{0};
+
+const std::chrono::milliseconds kSampleInterval(1);
+
+void* countedAllocate(std::size_t size) {
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    g_heapBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* countedAllocateAligned(std::size_t size, std::align_val_t alignment) {
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    g_heapBytes.fetch_add(size, std::memory_order_relaxed);
+    void* pointer = nullptr;
+    std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    if (posix_memalign(&pointer, align, size == 0 ? 1 : size) != 0) {
+        return nullptr;
+    }
+    return pointer;
+}
+
+// Returns the current resident set size in bytes, or 0 if it cannot be read.
+std::uint64_t residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    std::uint64_t sizePages = 0;
+    std::uint64_t residentPages = 0;
+    statm >> sizePages >> residentPages;
+    return residentPages * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Returns the kernel's high-water mark of the resident set (VmHWM) in bytes.
+std::uint64_t peakResidentBytes() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            std::istringstream fields(line.substr(6));
+            std::uint64_t kilobytes = 0;
+            fields >> kilobytes;
+            return kilobytes * 1024;
+        }
+    }
+    return 0;
+}
+
+// Resets VmHWM to the current resident set; returns false where that is not permitted.
+bool resetPeakResident() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.flush();
+    return clearRefs.good();
+}
+
+} // namespace
+
+
+// Replacements of the global allocation functions, so that every allocation of the
+// process is counted. They forward to malloc and posix_memalign.
+void* operator new(std::size_t size) {
+    void* pointer = countedAllocate(size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* pointer = countedAllocateAligned(size, alignment);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAllocateAligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { std::free(pointer); }
+
+
+AllocationCounters allocationCounters() {
+    shuffle::MappedBufferStats mapped = shuffle::mappedBufferStats();
+    AllocationCounters counters;
+    counters.allocations = g_heapAllocations.load() + mapped.allocations;
+    counters.bytes = g_heapBytes.load() + mapped.bytes;
+    return counters;
+}
+
+
+MemoryMonitor::MemoryMonitor()
+    : m_startResident(residentBytes()),
+      m_peakReset(resetPeakResident()),
+      m_running(true),
+      m_sampledPeak(m_startResident) {
+    if (!m_peakReset) {
+        m_sampler = std::thread([this] {
+            while (m_running.load()) {
+                std::uint64_t current = residentBytes();
+                std::uint64_t peak = m_sampledPeak.load();
+                while (current > peak && !m_sampledPeak.compare_exchange_weak(peak, current)) {
+                }
+                std::this_thread::sleep_for(kSampleInterval);
+            }
+        });
+    }
+    // Taken last, so that the sampler thread's own stack is not attributed to the run.
+    m_start = allocationCounters();
+}
+
+MemoryMonitor::~MemoryMonitor() {
+    m_running.store(false);
+    if (m_sampler.joinable()) {
+        m_sampler.join();
+    }
+}
+
+MemoryUsage MemoryMonitor::stop() {
+    AllocationCounters end = allocationCounters();
+    std::uint64_t current = residentBytes();
+
+    m_running.store(false);
+    if (m_sampler.joinable()) {
+        m_sampler.join();
+    }
+
+    MemoryUsage usage;
+    usage.allocations = end.allocations - m_start.allocations;
+    usage.allocatedBytes = end.bytes - m_start.bytes;
+    usage.startResidentBytes = m_startResident;
+    usage.peakResidentBytes = std::max(current, m_peakReset ? peakResidentBytes() : m_sampledPeak.load());
+    usage.sampled = !m_peakReset;
+    return usage;
+}
+
+
+void printMemoryUsage(const MemoryUsage& usage, unsigned int calls) {
+    const double mebibyte = 1024.0 * 1024.0;
+    double perCall = calls > 0 ? 1.0 / calls : 0.0;
+
+    std::cout << "\nMemory" << (usage.sampled ? " (peak sampled every 1 ms)" : "") << ":\n"
+              << std::setw(15) << "Statistic" << std::setw(20) << "Total" << std::setw(20) << "Per shuffle" << "\n"
+              << std::fixed << std::setprecision(1)
+              << std::setw(15) << "allocations" << std::setw(20) << usage.allocations
+              << std::setw(20) << usage.allocations * perCall << "\n"
+              << std::setw(15) << "allocated MiB" << std::setw(20) << usage.allocatedBytes / mebibyte
+              << std::setw(20) << usage.allocatedBytes * perCall / mebibyte << "\n"
+              << std::setw(15) << "peak RSS MiB" << std::setw(20) << usage.peakResidentBytes / mebibyte
+              << std::setw(20) << "" << "\n"
+              << std::setw(15) << "RSS growth MiB" << std::setw(20)
+              << (static_cast<double>(usage.peakResidentBytes) - static_cast<double>(usage.startResidentBytes)) / mebibyte
+              << "\n";
+}
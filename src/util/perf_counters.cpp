@@ -0,0 +1,251 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "util/perf_counters.hpp"
+
+
+namespace {
+
+const char* const kPerfEventNames[kPerfEventCount] = {
+    "Cycles", "Instructions", "LLC misses", "dTLB misses", "Branch misses"
+};
+
+std::uint64_t steadyNanoseconds() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#ifdef __linux__
+// Fills the type and config of a perf_event_attr for the event.
+void describeEvent(PerfEvent event, perf_event_attr& attr) {
+    const std::uint64_t readMiss =
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    switch (event) {
+        case kPerfCycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case kPerfInstructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case kPerfLlcMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_LL | readMiss;
+            break;
+        case kPerfDtlbMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | readMiss;
+            break;
+        default:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+    }
+}
+
+int openEvent(PerfEvent event, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    describeEvent(event, attr);
+    attr.disabled = groupFd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+#endif
+
+// Whether the counts of the sample were measured at all; a group that the kernel never
+// scheduled reports zeros that mean nothing.
+bool counted(const PerfSample& sample, PerfEvent event) {
+    return sample.valid[event] && sample.timeRunning > 0;
+}
+
+// Estimates the count over the whole enabled time from the part the group was running.
+double scaledCount(const PerfSample& sample, PerfEvent event) {
+    double scale = static_cast<double>(sample.timeEnabled) / static_cast<double>(sample.timeRunning);
+    return static_cast<double>(sample.values[event]) * scale;
+}
+
+std::string formatCount(const PerfSample& sample, PerfEvent event) {
+    if (!counted(sample, event)) {
+        return "n/a";
+    }
+    return std::to_string(static_cast<std::uint64_t>(scaledCount(sample, event) + 0.5));
+}
+
+} // namespace
+
+
+PerfCounters::PerfCounters() : m_leaderFd(-1) {
+#ifdef __linux__
+    for (int e = 0; e < kPerfEventCount; ++e) {
+        PerfEvent event = static_cast<PerfEvent>(e);
+        int fd = openEvent(event, m_leaderFd);
+        if (fd < 0) {
+            if (m_leaderFd == -1 && m_unavailableReason.empty()) {
+                m_unavailableReason = std::string("perf_event_open failed: ") + std::strerror(errno);
+            }
+            continue;
+        }
+        if (m_leaderFd == -1) {
+            m_leaderFd = fd;
+        }
+        m_fds.push_back(fd);
+        m_events.push_back(event);
+    }
+
+    if (m_leaderFd != -1) {
+        ioctl(m_leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        m_unavailableReason.clear();
+    }
+#else
+    m_unavailableReason = "hardware counters are only supported on Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int fd : m_fds) {
+        close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    return m_leaderFd != -1;
+}
+
+const std::string& PerfCounters::unavailableReason() const {
+    return m_unavailableReason;
+}
+
+PerfSample PerfCounters::read() const {
+    PerfSample sample;
+    sample.nanoseconds = steadyNanoseconds();
+#ifdef __linux__
+    if (m_leaderFd == -1) {
+        return sample;
+    }
+
+    // Layout of the group read: the number of events, the time enabled, the time
+    // running, then one value per event.
+    std::uint64_t buffer[3 + kPerfEventCount];
+    ssize_t bytes = ::read(m_leaderFd, buffer, sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(3 * sizeof(std::uint64_t))) {
+        return sample;
+    }
+    std::uint64_t count = buffer[0];
+    sample.timeEnabled = buffer[1];
+    sample.timeRunning = buffer[2];
+    for (std::uint64_t i = 0; i < count && i < m_events.size(); ++i) {
+        sample.values[m_events[i]] = buffer[3 + i];
+        sample.valid[m_events[i]] = true;
+    }
+#endif
+    return sample;
+}
+
+
+PhaseProfiler::PhaseProfiler(const PerfCounters& counters)
+    : m_counters(counters), m_last(counters.read()), m_totals() {
+}
+
+void PhaseProfiler::attribute() {
+    PerfSample now = m_counters.read();
+    shuffle::Phase current = m_stack.empty() ? shuffle::Phase::Count : m_stack.back();
+    PerfSample& total = m_totals[static_cast<std::size_t>(current)];
+    for (int e = 0; e < kPerfEventCount; ++e) {
+        if (now.valid[e] && m_last.valid[e]) {
+            total.values[e] += now.values[e] - m_last.values[e];
+            total.valid[e] = true;
+        }
+    }
+    total.nanoseconds += now.nanoseconds - m_last.nanoseconds;
+    total.timeEnabled += now.timeEnabled - m_last.timeEnabled;
+    total.timeRunning += now.timeRunning - m_last.timeRunning;
+    m_last = now;
+}
+
+void PhaseProfiler::enterPhase(shuffle::Phase phase) {
+    attribute();
+    m_stack.push_back(phase);
+}
+
+void PhaseProfiler::leavePhase(shuffle::Phase phase) {
+    attribute();
+    if (!m_stack.empty() && m_stack.back() == phase) {
+        m_stack.pop_back();
+    }
+}
+
+void PhaseProfiler::printReport(const std::string& funcName) {
+    attribute();
+
+    std::cout << "\nHardware counters for " << funcName << " (calling thread only):\n";
+    if (!m_counters.available()) {
+        std::cout << "  Unavailable (" << m_counters.unavailableReason()
+                  << "); showing wall-clock time only.\n";
+    }
+
+    std::cout << std::setw(12) << "Phase"
+              << std::setw(12) << "Time (ms)";
+    for (int e = 0; e < kPerfEventCount; ++e) {
+        std::cout << std::setw(16) << kPerfEventNames[e];
+    }
+    std::cout << std::setw(8) << "IPC" << "\n";
+
+    PerfSample overall;
+    for (std::size_t p = 0; p <= static_cast<std::size_t>(shuffle::Phase::Count) + 1; ++p) {
+        bool isTotal = p == static_cast<std::size_t>(shuffle::Phase::Count) + 1;
+        const PerfSample& sample = isTotal ? overall : m_totals[p];
+        if (!isTotal) {
+            if (sample.nanoseconds == 0) {
+                continue;
+            }
+            for (int e = 0; e < kPerfEventCount; ++e) {
+                overall.values[e] += sample.values[e];
+                overall.valid[e] = overall.valid[e] || sample.valid[e];
+            }
+            overall.nanoseconds += sample.nanoseconds;
+            overall.timeEnabled += sample.timeEnabled;
+            overall.timeRunning += sample.timeRunning;
+        }
+
+        std::cout << std::setw(12) << (isTotal ? "total" : shuffle::phaseName(static_cast<shuffle::Phase>(p)))
+                  << std::setw(12) << std::fixed << std::setprecision(3) << sample.nanoseconds / 1e6;
+        for (int e = 0; e < kPerfEventCount; ++e) {
+            std::cout << std::setw(16) << formatCount(sample, static_cast<PerfEvent>(e));
+        }
+        if (counted(sample, kPerfCycles) && counted(sample, kPerfInstructions) && sample.values[kPerfCycles] > 0) {
+            double ipc = static_cast<double>(sample.values[kPerfInstructions]) / sample.values[kPerfCycles];
+            std::cout << std::setw(8) << std::setprecision(2) << ipc;
+        } else {
+            std::cout << std::setw(8) << "n/a";
+        }
+        std::cout << "\n";
+        if (isTotal && m_counters.available() && overall.timeRunning < overall.timeEnabled) {
+            double share = overall.timeEnabled > 0
+                ? 100.0 * static_cast<double>(overall.timeRunning) / static_cast<double>(overall.timeEnabled)
+                : 0.0;
+            std::cout << "  The counters were multiplexed and ran " << std::setprecision(1) << share
+                      << "% of the time; counts are scaled estimates.\n";
+        }
+    }
+    std::cout << std::string(80, '=') << "\n\n";
+}
@@ -0,0 +1,291 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/helpers.hpp"
+#include "util/pipeline.hpp"
+#include "util/shuffler.hpp"
+
+
+namespace {
+
+// Batches are sized so that one write moves about this many bytes.
+const std::size_t kBatchBytes = std::size_t(1) << 20;
+
+// Buffers in flight per worker: one being filled and one queued or being written.
+const unsigned int kBuffersPerWorker = 2;
+
+// Looks up a sequential algorithm of the registry. The parallel ones would compete with
+// the other workers for the same cores, so they cannot be streamed.
+ShuffleFunc findStreamingAlgorithm(const std::string& name) {
+    std::string supported;
+    for (const Algorithm& algorithm : availableAlgorithms()) {
+        if (algorithm.parallel) {
+            continue;
+        }
+        if (name == algorithm.name) {
+            return algorithm.func;
+        }
+        supported += std::string(supported.empty() ? "" : ", ") + algorithm.name;
+    }
+    throw std::runtime_error("Error: " + name + " cannot be streamed; use one of " + supported + ".");
+}
+
+// A batch of consecutive permutations in one buffer.
+struct Batch {
+    Permutation values;
+    std::size_t permutations;
+};
+
+// A blocking FIFO of batch pointers. pop() returns nullptr once the queue is closed
+// and empty.
+class BatchQueue {
+    public:
+        void push(Batch* batch) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_batches.push_back(batch);
+            }
+            m_ready.notify_one();
+        }
+
+        Batch* pop(double& waitSeconds) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_batches.empty() && !m_closed) {
+                std::chrono::steady_clock::time_point since = std::chrono::steady_clock::now();
+                m_ready.wait(lock, [this] { return !m_batches.empty() || m_closed; });
+                waitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+            }
+            if (m_batches.empty()) {
+                return nullptr;
+            }
+            Batch* batch = m_batches.front();
+            m_batches.pop_front();
+            return batch;
+        }
+
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_closed = true;
+            }
+            m_ready.notify_all();
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_ready;
+        std::deque<Batch*> m_batches;
+        bool m_closed = false;
+};
+
+// Writes all of [data, data + bytes) to `fd`; returns false once the reader is gone.
+bool writeAll(int fd, const char* data, std::size_t bytes) {
+    while (bytes > 0) {
+        ssize_t written = ::write(fd, data, bytes);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EPIPE) {
+                return false;
+            }
+            throw std::runtime_error(std::string("Error: cannot write permutations: ") + std::strerror(errno));
+        }
+        data += written;
+        bytes -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+
+PipelineResult runGenerationPipeline(
+    const std::string& algorithm,
+    unsigned int length,
+    std::uint64_t count,
+    const std::string& outputPath,
+    unsigned int workers
+) {
+    ShuffleFunc shuffleFunc = findStreamingAlgorithm(algorithm);
+    workers = std::max(1u, workers);
+
+    int fd = STDOUT_FILENO;
+    if (!outputPath.empty()) {
+        fd = ::open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Error: cannot open " + outputPath + ": " + std::strerror(errno));
+        }
+    } else if (::isatty(STDOUT_FILENO)) {
+        throw std::runtime_error("Error: refusing to write binary permutations to a terminal; "
+                                 "redirect stdout or use --output.");
+    }
+
+    // A reader that closes the pipe should end the run, not kill the process.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::size_t permutationBytes = std::size_t(length) * sizeof(unsigned int);
+    std::size_t batchSize = std::max<std::size_t>(1, kBatchBytes / permutationBytes);
+    if (count != 0) {
+        batchSize = static_cast<std::size_t>(std::min<std::uint64_t>(batchSize, (count + workers - 1) / workers));
+    }
+
+    std::vector<Batch> batches(workers * kBuffersPerWorker);
+    BatchQueue freeBatches;
+    BatchQueue filledBatches;
+    for (Batch& batch : batches) {
+        batch.values.resize(batchSize * length);
+        freeBatches.push(&batch);
+    }
+
+    std::atomic<std::uint64_t> nextPermutation{0};
+    std::atomic<bool> stopping{false};
+    std::atomic<unsigned int> activeWorkers{workers};
+    std::vector<double> workerWaits(workers, 0.0);
+
+    // Every worker shuffles with its own fork of one randomly seeded shuffler.
+    NumbersShuffler seedShuffler;
+    std::vector<NumbersShuffler> shufflers;
+    for (unsigned int w = 0; w < workers; w++) {
+        shufflers.push_back(seedShuffler.fork());
+    }
+
+    // The first exception of any worker, rethrown by the writer once all have stopped.
+    std::mutex errorMutex;
+    std::exception_ptr workerError;
+
+    PipelineResult result;
+    result.algorithm = algorithm;
+    result.length = length;
+    result.workers = workers;
+    result.permutations = 0;
+    result.bytes = 0;
+    result.workerWaitSeconds = 0.0;
+    result.writerWaitSeconds = 0.0;
+    result.outputClosed = false;
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned int w = 0; w < workers; w++) {
+        threads.emplace_back([&, w] {
+            try {
+                while (!stopping.load()) {
+                    std::uint64_t first = nextPermutation.fetch_add(batchSize);
+                    if (count != 0 && first >= count) {
+                        break;
+                    }
+                    Batch* batch = freeBatches.pop(workerWaits[w]);
+                    if (batch == nullptr) {
+                        break;
+                    }
+
+                    batch->permutations = count == 0
+                        ? batchSize
+                        : static_cast<std::size_t>(std::min<std::uint64_t>(batchSize, count - first));
+                    for (std::size_t p = 0; p < batch->permutations; p++) {
+                        Permutation perm = (shufflers[w].*shuffleFunc)(length);
+                        std::copy(perm.begin(), perm.end(), batch->values.begin() + p * length);
+                    }
+                    filledBatches.push(batch);
+                }
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!workerError) {
+                        workerError = std::current_exception();
+                    }
+                }
+                stopping.store(true);
+                freeBatches.close();
+            }
+            if (activeWorkers.fetch_sub(1) == 1) {
+                filledBatches.close();
+            }
+        });
+    }
+
+    // The calling thread is the writer.
+    try {
+        while (Batch* batch = filledBatches.pop(result.writerWaitSeconds)) {
+            if (stopping.load()) {
+                break;
+            }
+            std::size_t bytes = batch->permutations * permutationBytes;
+            if (!writeAll(fd, reinterpret_cast<const char*>(batch->values.data()), bytes)) {
+                result.outputClosed = true;
+                break;
+            }
+            result.permutations += batch->permutations;
+            result.bytes += bytes;
+            freeBatches.push(batch);
+        }
+    } catch (...) {
+        stopping.store(true);
+        freeBatches.close();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        throw;
+    }
+
+    stopping.store(true);
+    freeBatches.close();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    if (workerError) {
+        if (fd != STDOUT_FILENO) {
+            ::close(fd);
+        }
+        std::rethrow_exception(workerError);
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    for (double wait : workerWaits) {
+        result.workerWaitSeconds += wait;
+    }
+
+    if (fd != STDOUT_FILENO) {
+        ::close(fd);
+    }
+    return result;
+}
+
+
+void printPipelineResult(const PipelineResult& result) {
+    const double megabyte = 1e6;
+    double seconds = result.seconds > 0.0 ? result.seconds : 1e-9;
+
+    std::cerr << "\nStreamed " << result.permutations << " permutations of " << result.length
+              << " elements using " << result.algorithm << " on " << result.workers << " worker"
+              << (result.workers == 1 ? "" : "s")
+              << (result.outputClosed ? " (the reader closed the output)" : "") << ":\n"
+              << std::fixed << std::setprecision(2)
+              << std::setw(28) << "elapsed (s)" << std::setw(20) << result.seconds << "\n"
+              << std::setw(28) << "permutations/s" << std::setw(20) << result.permutations / seconds << "\n"
+              << std::setw(28) << "output (MB/s)" << std::setw(20) << result.bytes / megabyte / seconds << "\n"
+              << std::setw(28) << "workers blocked on writer" << std::setw(19)
+              << 100.0 * result.workerWaitSeconds / (seconds * result.workers) << "%\n"
+              << std::setw(28) << "writer starved" << std::setw(19)
+              << 100.0 * result.writerWaitSeconds / seconds << "%\n";
+    std::cerr << std::string(80, '=') << "\n\n";
+}
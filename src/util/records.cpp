@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "shuffle/algorithms.hpp"
+#include "shuffle/permutation.hpp"
+#include "util/records.hpp"
+
+
+namespace {
+
+// A record of exactly `Bytes` bytes whose key identifies its original position.
+template <std::size_t Bytes>
+struct Record {
+    std::uint32_t key;
+    unsigned char payload[Bytes - sizeof(std::uint32_t)];
+};
+
+const char* strategyName(shuffle::PermutationStrategy strategy) {
+    switch (strategy) {
+        case shuffle::PermutationStrategy::Direct:      return "direct";
+        case shuffle::PermutationStrategy::Gather:      return "gather";
+        case shuffle::PermutationStrategy::CycleFollow: return "cycle";
+        default:                                        return "auto";
+    }
+}
+
+// Returns the average time in milliseconds of shuffling `records` with `strategy`.
+// One untimed shuffle runs first, so that the reused buffers are already faulted in.
+template <std::size_t Bytes>
+double timeStrategy(
+    std::vector<Record<Bytes>>& records,
+    shuffle::PermutationStrategy strategy,
+    unsigned int iterations,
+    std::mt19937& engine
+) {
+    shuffle::IndirectShuffler<Record<Bytes>> shuffler;
+    auto indexShuffle = [](auto first, auto last, std::mt19937& rng) {
+        shuffle::durstenfeldShuffle(first, last, rng);
+    };
+
+    shuffler(records.begin(), records.end(), engine, indexShuffle, strategy);
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    for (unsigned int iter = 0; iter < iterations; ++iter) {
+        shuffler(records.begin(), records.end(), engine, indexShuffle, strategy);
+    }
+    std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(endTime - startTime).count() / iterations;
+}
+
+template <std::size_t Bytes>
+void benchmarkRecordSize(unsigned int length, unsigned int iterations, std::mt19937& engine) {
+    std::vector<Record<Bytes>> records(length);
+    for (unsigned int i = 0; i < length; ++i) {
+        records[i].key = i;
+    }
+
+    shuffle::PermutationStrategy chosen = shuffle::choosePermutationStrategy(Bytes, length);
+    std::cout << std::setw(10) << Bytes;
+    const shuffle::PermutationStrategy strategies[] = {
+        shuffle::PermutationStrategy::Direct,
+        shuffle::PermutationStrategy::Gather,
+        shuffle::PermutationStrategy::CycleFollow
+    };
+    for (shuffle::PermutationStrategy strategy : strategies) {
+        double elapsed = timeStrategy(records, strategy, iterations, engine);
+        std::cout << std::setw(15) << std::fixed << std::setprecision(2) << elapsed;
+    }
+    std::cout << std::setw(10) << strategyName(chosen) << "\n";
+}
+
+} // namespace
+
+
+void produceRecordBenchmark(unsigned int length, unsigned int iterations) {
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    std::cout << "Shuffling " << length << " records, average of "
+              << iterations << " iterations (ms):\n\n";
+    std::cout << std::setw(10) << "Bytes"
+              << std::setw(15) << "Direct"
+              << std::setw(15) << "Gather"
+              << std::setw(15) << "Cycle"
+              << std::setw(10) << "Auto" << "\n";
+
+    std::mt19937 engine{ std::random_device{}() };
+    benchmarkRecordSize<64>(length, iterations, engine);
+    benchmarkRecordSize<128>(length, iterations, engine);
+    benchmarkRecordSize<256>(length, iterations, engine);
+    std::cout << std::string(80, '=') << "\n\n";
+}
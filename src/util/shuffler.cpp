@@ -1,27 +1,68 @@
 #ifndef NUMBERS_SHUFFLER_CPP
 #define NUMBERS_SHUFFLER_CPP
 
-#include <algorithm>
-#include <ctime>
-#include <limits>
+#include <cstddef>
+#include <cstdint>
 #include <numeric>
-#include <omp.h>
 #include <random>
-#include <utility> 
 
+#include "shuffle/algorithms.hpp"
+#include "shuffle/inside_out.hpp"
+#include "shuffle/lehmer.hpp"
+#include "shuffle/numa.hpp"
+#include "shuffle/phase.hpp"
+#include "shuffle/rao_sandelius.hpp"
 #include "util/shuffler.hpp"
 
 
-bool NumbersShuffler::s_randSeeded = false;
-std::mt19937 NumbersShuffler::s_mtEngine{ std::random_device{}() };
+namespace {
 
+// Element i of the identity permutation 1..length, for the algorithms that generate the
+// numbers themselves.
+unsigned int identityValue(std::size_t i) {
+    return static_cast<unsigned int>(i + 1);
+}
 
-NumbersShuffler::NumbersShuffler() {
-    // Seed std::rand() only once.
-    if (!s_randSeeded) {
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
-        s_randSeeded = true;
-    }
+} // namespace
+
+
+NumbersShuffler::NumbersShuffler() : NumbersShuffler(std::random_device{}()) {}
+
+NumbersShuffler::NumbersShuffler(std::uint32_t seed) : m_pool(nullptr), m_grain(0) {
+    this->seed(seed);
+}
+
+void NumbersShuffler::seed(std::uint32_t seed) {
+    std::seed_seq seeds{seed};
+    m_mtEngine.seed(seeds);
+    m_randEngine.seed(seed);
+}
+
+NumbersShuffler NumbersShuffler::fork() {
+    NumbersShuffler copy(*this);
+    // Several words of seed material, as in shuffle::detail::seedEngines, so that forks do
+    // not start to collide after a few tens of thousands of them.
+    std::seed_seq seeds{m_mtEngine(), m_mtEngine(), m_mtEngine(), m_mtEngine()};
+    copy.m_mtEngine.seed(seeds);
+    copy.m_randEngine.seed(static_cast<std::uint32_t>(m_mtEngine()));
+    return copy;
+}
+
+void NumbersShuffler::setThreadPool(shuffle::WorkStealingPool* pool) {
+    m_pool = pool;
+}
+
+void NumbersShuffler::setGrain(std::size_t grain) {
+    m_grain = grain;
+}
+
+
+// Returns the numbers 1 through length in order.
+Permutation NumbersShuffler::identityPermutation(unsigned int length) {
+    shuffle::PhaseScope scope(shuffle::Phase::Init);
+    Permutation numbers(length);
+    std::iota(numbers.begin(), numbers.end(), 1);
+    return numbers;
 }
 
 
@@ -32,7 +73,7 @@ NumbersShuffler::NumbersShuffler() {
  * performs a "naive" shuffle by iterating over each element and swapping it with an
  * element at a randomly chosen index. The random index is computed using:
  *
- *     std::rand() % length
+ *     rand() % length
  *
  * **Important Caveats:**
  *
@@ -40,34 +81,31 @@ NumbersShuffler::NumbersShuffler() {
  *    This shuffle algorithm is naive because it swaps each element with any other
  *    element in the entire range, regardless of whether it has already been shuffled.
  *    In contrast, the unbiased Fisher–Yates shuffle restricts the random index to the
- *    unshuffled portion (i.e., using `std::rand() % (length - i)`). The current approach
+ *    unshuffled portion (i.e., using `rand() % (length - i)`). The current approach
  *    leads to some permutations being more likely than others.
  *
  * 2. **Modulo Bias:**  
- *    Using the modulo operator (`%`) to reduce the range of `std::rand()` can introduce
- *    bias if the range of `std::rand()` (typically 0 to RAND_MAX) is not an exact multiple
+ *    Using the modulo operator (`%`) to reduce the range of `rand()` can introduce
+ *    bias if the range of `rand()` (typically 0 to RAND_MAX) is not an exact multiple
  *    of `length`.  
- *    For example, if RAND_MAX is 32767 and `length` is 100, then there are 32768 possible
- *    outcomes from `std::rand()`. Since 32768 divided by 100 gives a quotient of 327 with a
- *    remainder of 68, the remainders 0 through 67 will occur 328 times each, while 68 through 99
- *    will occur only 327 times each, resulting in a biased distribution.
+ *    For example, if RAND_MAX were 32767 and `length` were 100, there would be 32768 possible
+ *    outcomes from `rand()`. Since 32768 divided by 100 gives a quotient of 327 with a
+ *    remainder of 68, the remainders 0 through 67 would occur 328 times each, while 68 through 99
+ *    would occur only 327 times each, resulting in a biased distribution.
  *
- * 3. **Quality of std::rand():**  
- *    The underlying random number generator, `std::rand()`, is generally considered low-quality.
- *    It is often implemented as a simple linear congruential generator, which may exhibit patterns
- *    or low entropy, further compounding the overall bias of the shuffle.
+ * 3. **Quality of rand():**  
+ *    The underlying random number generator is the instance's rand_r()-style linear
+ *    congruential generator, with glibc's range of 0 to 2^31 - 1. Such generators exhibit
+ *    patterns and low entropy, further compounding the overall bias of the shuffle.
  *
  * @param length The number of elements in the sequence to be shuffled.
  * @return A vector of unsigned integers from 1 to `length` in a pseudo-random order.
  */
-std::vector<unsigned int> NumbersShuffler::biasedNaiveShuffle(unsigned int length) const {
-    std::vector<unsigned int> numbers(length);
-    std::iota(numbers.begin(), numbers.end(), 1);
+Permutation NumbersShuffler::biasedNaiveShuffle(unsigned int length) {
+    Permutation numbers = identityPermutation(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
 
-    for (unsigned int i = 0; i < length; i++) {
-        unsigned int randomIndex = std::rand() % length;
-        std::swap(numbers[i], numbers[randomIndex]);
-    }
+    shuffle::biasedNaiveShuffle(numbers.begin(), numbers.end(), m_randEngine);
 
     return numbers;
 }
@@ -84,16 +122,11 @@ std::vector<unsigned int> NumbersShuffler::biasedNaiveShuffle(unsigned int lengt
  * @param length The number of elements in the sequence to be shuffled.
  * @return A vector of unsigned integers from 1 to `length` in a pseudo-random order.
  */
-std::vector<unsigned int> NumbersShuffler::naiveShuffle(unsigned int length) const {
-    std::vector<unsigned int> numbers(length);
-    std::iota(numbers.begin(), numbers.end(), 1);
+Permutation NumbersShuffler::naiveShuffle(unsigned int length) {
+    Permutation numbers = identityPermutation(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
 
-    for (unsigned int i = 0; i < length; i++) {
-        // Generate a random integer
-        std::uniform_int_distribution<> dis(0, length - 1);
-        unsigned int randomIndex = dis(s_mtEngine);
-        std::swap(numbers[i], numbers[randomIndex]);
-    }
+    shuffle::naiveShuffle(numbers.begin(), numbers.end(), m_mtEngine);
 
     return numbers;
 }
@@ -103,34 +136,26 @@ std::vector<unsigned int> NumbersShuffler::naiveShuffle(unsigned int length) con
  * @brief Shuffles a sequence in a biased way using a variant of the Fisher–Yates algorithm.
  *
  * This implementation creates a vector containing numbers from 1 to length,
- * then repeatedly selects a random element from the remaining numbers, moves it to
- * a new vector, and erases it from the original vector. This process continues until
- * all elements have been moved to the shuffled vector.
+ * then repeatedly selects a random element from the remaining numbers and rotates it
+ * to the end of the shuffled prefix, which is equivalent to striking it out of the
+ * remaining list. This process continues until no numbers are left.
  *
- * @note This approach is less efficient since removing
- *       an element from a vector has O(n) complexity.
+ * @note This approach is less efficient since striking out
+ *       an element shifts the remaining ones, which has O(n) complexity.
  * 
- * @note This method uses std::rand() with the modulo operator to generate random indices,
+ * @note This method uses rand() with the modulo operator to generate random indices,
  *       which can introduce modulo bias if RAND_MAX is not a multiple of the range.
  *
  * @param length The number of elements to shuffle.
  * @return A vector containing the shuffled sequence.
  */
-std::vector<unsigned int> NumbersShuffler::biasedFisherYatesShuffle(unsigned int length) const {
-    std::vector<unsigned int> numbers(length);
-    std::vector<unsigned int> shuffled;
-    std::iota(numbers.begin(), numbers.end(), 1);
+Permutation NumbersShuffler::biasedFisherYatesShuffle(unsigned int length) {
+    Permutation numbers = identityPermutation(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
 
-    // While there are still numbers left, pick a random index,
-    // move the element at that index to the shuffled vector,
-    // and remove it from the original vector.
-    while (!numbers.empty()) {
-        unsigned int randomIndex = std::rand() % numbers.size();
-        shuffled.push_back(numbers[randomIndex]);
-        numbers.erase(numbers.begin() + randomIndex);
-    }
+    shuffle::biasedFisherYatesShuffle(numbers.begin(), numbers.end(), m_randEngine);
 
-    return shuffled;
+    return numbers;
 }
 
 
@@ -138,32 +163,23 @@ std::vector<unsigned int> NumbersShuffler::biasedFisherYatesShuffle(unsigned int
  * @brief Shuffles a sequence using a variant of the Fisher–Yates algorithm.
  *
  * This implementation creates a vector containing numbers from 1 to length,
- * then repeatedly selects a random element from the remaining numbers, moves it to
- * a new vector, and erases it from the original vector. This process continues until
- * all elements have been moved to the shuffled vector.
+ * then repeatedly selects a random element from the remaining numbers and rotates it
+ * to the end of the shuffled prefix, which is equivalent to striking it out of the
+ * remaining list. This process continues until no numbers are left.
  *
- * @note This approach is less efficient since removing
- *       an element from a vector has O(n) complexity.
+ * @note This approach is less efficient since striking out
+ *       an element shifts the remaining ones, which has O(n) complexity.
  *
  * @param length The number of elements to shuffle.
  * @return A vector containing the shuffled sequence.
  */
-std::vector<unsigned int> NumbersShuffler::fisherYatesShuffle(unsigned int length) const {
-    std::vector<unsigned int> numbers(length);
-    std::vector<unsigned int> shuffled;
-    std::iota(numbers.begin(), numbers.end(), 1);
+Permutation NumbersShuffler::fisherYatesShuffle(unsigned int length) {
+    Permutation numbers = identityPermutation(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
 
-    // While there are still numbers left, pick a random index,
-    // move the element at that index to the shuffled vector,
-    // and remove it from the original vector.
-    while (!numbers.empty()) {
-        std::uniform_int_distribution<> dis(0, numbers.size() - 1);
-        unsigned int randomIndex = dis(s_mtEngine);
-        shuffled.push_back(numbers[randomIndex]);
-        numbers.erase(numbers.begin() + randomIndex);
-    }
+    shuffle::fisherYatesShuffle(numbers.begin(), numbers.end(), m_mtEngine);
 
-    return shuffled;
+    return numbers;
 }
 
 
@@ -172,22 +188,17 @@ std::vector<unsigned int> NumbersShuffler::fisherYatesShuffle(unsigned int lengt
  *
  * This function shuffles a vector of numbers from 1 to length by iterating backwards
  * and swapping each element with an element at a random index in the range [0, i]. However,
- * it uses std::rand() with the modulo operator to generate random indices, which can introduce
+ * it uses rand() with the modulo operator to generate random indices, which can introduce
  * modulo bias if RAND_MAX is not a multiple of the range.
  *
  * @param length The number of elements to shuffle.
  * @return A vector containing the shuffled sequence.
  */
-std::vector<unsigned int> NumbersShuffler::biasedDurstenfeldShuffle(unsigned int length) const {
-    std::vector<unsigned int> numbers(length);
-    std::iota(numbers.begin(), numbers.end(), 1);
+Permutation NumbersShuffler::biasedDurstenfeldShuffle(unsigned int length) {
+    Permutation numbers = identityPermutation(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
 
-    // Loop from the last element down to the second element
-    for (unsigned int i = numbers.size() - 1; i > 0; --i) {
-        // Generate a random integer j such that 0 <= j <= i
-        unsigned int randomIndex = std::rand() % (i + 1);
-        std::swap(numbers[i], numbers[randomIndex]);
-    }
+    shuffle::biasedDurstenfeldShuffle(numbers.begin(), numbers.end(), m_randEngine);
 
     return numbers;
 }
@@ -204,19 +215,11 @@ std::vector<unsigned int> NumbersShuffler::biasedDurstenfeldShuffle(unsigned int
  * @param length The number of elements to shuffle.
  * @return A vector containing the shuffled sequence.
  */
-std::vector<unsigned int> NumbersShuffler::durstenfeldShuffle(unsigned int length) const {
-    std::vector<unsigned int> numbers(length);
-    std::iota(numbers.begin(), numbers.end(), 1);
+Permutation NumbersShuffler::durstenfeldShuffle(unsigned int length) {
+    Permutation numbers = identityPermutation(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
 
-    // Loop from the last element down to the second element
-    for (unsigned int i = numbers.size() - 1; i > 0; --i) {
-        // Generate a random integer j such that 0 <= j <= i
-        std::uniform_int_distribution<> dis(0, i);
-        unsigned int randomIndex = dis(s_mtEngine);
-
-        // Swap elements at indices i and randomIndex
-        std::swap(numbers[i], numbers[randomIndex]);
-    }
+    shuffle::durstenfeldShuffle(numbers.begin(), numbers.end(), m_mtEngine);
 
     return numbers;
 }
@@ -238,98 +241,16 @@ std::vector<unsigned int> NumbersShuffler::durstenfeldShuffle(unsigned int lengt
  * @param length The number of elements to shuffle.
  * @return A vector containing the numbers 1 to length in a pseudo-random order.
  */
-std::vector<unsigned int> NumbersShuffler::randomShuffle(unsigned int length) const {
-    std::vector<unsigned int> numbers(length);
-    std::iota(numbers.begin(), numbers.end(), 1);
-    std::uniform_int_distribution<unsigned int> dis(0, std::numeric_limits<unsigned int>::max());
-
-    // Create a temporary vector of pairs: each pair contains a random key and an element.
-    std::vector<std::pair<unsigned int, unsigned int>> paired;
-    paired.reserve(length);
+Permutation NumbersShuffler::randomShuffle(unsigned int length) {
+    Permutation numbers = identityPermutation(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
 
-    // Pair each element with a random key.
-    for (unsigned int i = 0; i < length; ++i) {
-        paired.emplace_back(dis(s_mtEngine), numbers[i]);
-    }
-
-    // Sort the vector of pairs based on the random key.
-    // Use a stable sort to preserve the random ordering of equal keys.
-    std::stable_sort(paired.begin(), paired.end(),
-        [](const std::pair<unsigned int, unsigned int>& a, const std::pair<unsigned int, unsigned int>& b) {
-            return a.first < b.first;
-        }
-    );
-
-    for (unsigned int i = 0; i < length; ++i) {
-        numbers[i] = paired[i].second;
-    }
+    shuffle::randomShuffle(numbers.begin(), numbers.end(), m_mtEngine);
 
     return numbers;
 }
 
 
-// Recursive merge shuffling.
-// For small subranges (fewer than 'threshold' elements), it falls back to Durstenfeld shuffle.
-void NumbersShuffler::mergeShuffleRec(
-    std::vector<unsigned int>& arr,
-    std::vector<unsigned int>& temp,
-    unsigned int start,
-    unsigned int end
-) {
-    unsigned int n = end - start;
-
-    if (n <= 1) {
-        return;
-    }
-
-    // Threshold to fall back to Durstenfeld algorithm.
-    const unsigned int threshold = 32;
-    if (n < threshold) {
-        for (unsigned int i = start; i < end; i++) {
-            // Choose a random index in the range [i, end - 1]
-            std::uniform_int_distribution<unsigned int> dis(i, end - 1);
-            unsigned int randomIndex = dis(s_mtEngine);
-            std::swap(arr[i], arr[randomIndex]);
-        }
-
-        return;
-    }
-
-    // Recursively split the range into two halves and shuffle each half.
-    unsigned int mid = start + n / 2;
-    mergeShuffleRec(arr, temp, start, mid);
-    mergeShuffleRec(arr, temp, mid, end);
-
-    unsigned int left = start;
-    unsigned int right = mid;
-    unsigned int idx = start;  // temp index starts at 'start'.
-
-    while (left < mid && right < end) {
-        unsigned int leftCount = mid - left;
-        unsigned int rightCount = end - right;
-        std::uniform_int_distribution<unsigned int> dis(0, leftCount + rightCount - 1);
-        unsigned int pick = dis(s_mtEngine);
-
-        if (pick < leftCount) {
-            temp[idx++] = arr[left++];
-        } else {
-            temp[idx++] = arr[right++];
-        }
-    }
-
-    // Append any remaining elements from the left or right half.
-
-    while (left < mid) {
-        temp[idx++] = arr[left++];
-    }
-
-    while (right < end) {
-        temp[idx++] = arr[right++];
-    }
-
-    std::copy(temp.begin() + start, temp.begin() + end, arr.begin() + start);
-}
-
 /**
  * @brief Shuffles a sequence using the merge shuffle algorithm.
  *
@@ -340,101 +261,156 @@ void NumbersShuffler::mergeShuffleRec(
  * @param length The number of elements to shuffle.
  * @return A vector containing the numbers 1 to length in a pseudo-random order.
  */
-std::vector<unsigned int> NumbersShuffler::mergeShuffle(unsigned int length) const {
-    std::vector<unsigned int> numbers(length);
-    std::iota(numbers.begin(), numbers.end(), 1);
+Permutation NumbersShuffler::mergeShuffle(unsigned int length) {
+    Permutation numbers = identityPermutation(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
 
     // Allocate the temporary vector once.
-    std::vector<unsigned int> temp(length);
+    Permutation temp(length);
 
-    mergeShuffleRec(numbers, temp, 0, numbers.size());
+    shuffle::mergeShuffle(numbers.begin(), numbers.end(), temp.begin(), m_mtEngine);
 
     return numbers;
 }
 
 
-void NumbersShuffler::parallelMergeShuffleRec(
-    std::vector<unsigned int>& arr,
-    std::vector<unsigned int>& temp,
-    unsigned int start,
-    unsigned int end
-) {
-    unsigned int n = end - start;
-    if (n <= 1) return;
-    
-    // Threshold to fall back to Durstenfeld shuffle.
-    const unsigned int threshold = 32;
-
-    if (n < threshold) {
-        for (unsigned int i = start; i < end; i++) {
-            // Choose a random index in the range [i, end - 1]
-            std::uniform_int_distribution<unsigned int> dis(i, end - 1);
-            unsigned int randomIndex = dis(getThreadLocalEngine());
-            std::swap(arr[i], arr[randomIndex]);
-        }
-
-        return;
+/**
+ * @brief Shuffles a sequence using the merge shuffle algorithm parallelised with OpenMP tasks.
+ *
+ * Works like mergeShuffle, but the left half of every sufficiently large subrange is
+ * shuffled in a separate task, and each thread draws from its own engine. The tasks run
+ * on the work-stealing pool set with setThreadPool, if any.
+ *
+ * @param length The number of elements to shuffle.
+ * @return A vector containing the numbers 1 to length in a pseudo-random order.
+ */
+Permutation NumbersShuffler::parallelMergeShuffle(unsigned int length) {
+    Permutation numbers = identityPermutation(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
+
+    Permutation temp(length);
+
+    // Per-thread (or, on the pool, per-task) engines are seeded from the instance's engine.
+    if (m_pool != nullptr) {
+        shuffle::parallelMergeShuffle(numbers.begin(), numbers.end(), temp.begin(), m_mtEngine,
+            *m_pool, m_grain != 0 ? m_grain : shuffle::kPoolTaskGrain);
+    } else {
+        shuffle::parallelMergeShuffle(numbers.begin(), numbers.end(), temp.begin(), m_mtEngine,
+            m_grain != 0 ? m_grain : shuffle::kParallelTaskThreshold);
     }
 
-    // Recursively split the range into two halves and shuffle each half.
-    unsigned int mid = start + n / 2;
+    return numbers;
+}
 
-    // Spawn tasks for the two halves (only create tasks if the subproblem is large enough)
-    #pragma omp task shared(arr, temp) if(n > threshold * 4)
+/**
+ * @brief Shuffles a sequence using a NUMA-aware partitioned merge shuffle.
+ *
+ * The output and scratch buffers are allocated without being touched and then filled
+ * in parallel, one contiguous chunk per OpenMP thread, so that the kernel places every
+ * chunk on the node of the thread that owns it. Each thread, pinned to a CPU of that
+ * node on multi-node machines, shuffles its own chunk; neighbouring chunks are then
+ * merged pairwise via uniformly random interleavings. Only the top levels of the merge
+ * tree touch memory on other nodes.
+ *
+ * @param length The number of elements to shuffle.
+ * @return A vector containing the numbers 1 to length in a pseudo-random order.
+ */
+Permutation NumbersShuffler::numaParallelMergeShuffle(unsigned int length) {
+    Permutation numbers(length);
+    Permutation temp(length);
     {
-        parallelMergeShuffleRec(arr, temp, start, mid);
+        shuffle::PhaseScope scope(shuffle::Phase::Init);
+        shuffle::numaFirstTouch(numbers.data(), temp.data(), numbers.size(), identityValue);
     }
 
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
+    shuffle::numaParallelMergeShuffle(numbers.begin(), numbers.end(), temp.begin(), m_mtEngine);
 
-    parallelMergeShuffleRec(arr, temp, mid, end);
-    #pragma omp taskwait
+    return numbers;
+}
 
-    // Merge
-    unsigned int left = start;
-    unsigned int right = mid;
-    unsigned int idx = start;  // temp index starts at 'start'.
 
-    while (left < mid && right < end) {
-        unsigned int leftCount = mid - left;
-        unsigned int rightCount = end - right;
-        std::uniform_int_distribution<unsigned int> dis(0, leftCount + rightCount - 1);
-        unsigned int pick = dis(getThreadLocalEngine());
+/**
+ * @brief Shuffles a short sequence from a single random draw.
+ *
+ * For up to 20 elements one number is drawn uniformly from [0, length!) and decoded as a
+ * Lehmer code into the permutation, by code specialised at compile time for each length.
+ * This replaces the length - 1 bounded draws of the Durstenfeld shuffle with one. From
+ * the instance's 32-bit Mersenne Twister, that draw takes one engine call for up to 12
+ * elements and at least two for 13 to 20. Longer sequences are shuffled with durstenfeldShuffle.
+ *
+ * @param length The number of elements to shuffle.
+ * @return A vector containing the numbers 1 to length in a pseudo-random order.
+ */
+Permutation NumbersShuffler::lehmerShuffle(unsigned int length) {
+    Permutation numbers = identityPermutation(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
 
-        if (pick < leftCount) {
-            temp[idx++] = arr[left++];
-        } else {
-            temp[idx++] = arr[right++];
-        }
-    }
+    shuffle::lehmerShuffle(numbers.begin(), numbers.end(), m_mtEngine);
 
-    // Append any remaining elements from the left or right half.
+    return numbers;
+}
 
-    while (left < mid) {
-        temp[idx++] = arr[left++];
-    }
 
-    while (right < end) {
-        temp[idx++] = arr[right++];
-    }
+/**
+ * @brief Generates a shuffled sequence with the inside-out Fisher–Yates shuffle.
+ *
+ * Unlike the other algorithms, it does not fill the vector with 1..length first: each
+ * number is written straight into a random slot among those already filled, moving that
+ * slot's number to the end. The output is written in one pass instead of two.
+ *
+ * @param length The number of elements to shuffle.
+ * @return A vector containing the numbers 1 to length in a pseudo-random order.
+ */
+Permutation NumbersShuffler::insideOutShuffle(unsigned int length) {
+    Permutation numbers(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
+
+    shuffle::insideOutShuffle(numbers.begin(), numbers.end(), m_mtEngine, identityValue);
 
-    std::copy(temp.begin() + start, temp.begin() + end, arr.begin() + start);
+    return numbers;
 }
 
+/**
+ * @brief Generates a shuffled sequence with a merge shuffle whose blocks generate their
+ * own numbers.
+ *
+ * The blocks at the bottom of the recursion write their numbers with the inside-out
+ * shuffle, so there is no separate fill pass. Every merge level writes from one buffer
+ * into the other instead of merging into scratch and copying back. For large
+ * permutations, the final merge writes the output with non-temporal stores.
+ *
+ * @param length The number of elements to shuffle.
+ * @return A vector containing the numbers 1 to length in a pseudo-random order.
+ */
+Permutation NumbersShuffler::insideOutMergeShuffle(unsigned int length) {
+    Permutation numbers(length);
+    Permutation temp(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
 
-std::vector<unsigned int> NumbersShuffler::parallelMergeShuffle(unsigned int length) const {
-    std::vector<unsigned int> numbers(length);
-    std::iota(numbers.begin(), numbers.end(), 1);
+    shuffle::insideOutMergeShuffle(numbers.data(), numbers.data() + numbers.size(), temp.data(), m_mtEngine,
+        identityValue
+    );
 
-    std::vector<unsigned int> temp(length);
+    return numbers;
+}
 
-    // Parallel region
-    #pragma omp parallel
-    {
-        #pragma omp single nowait
-        {
-            parallelMergeShuffleRec(numbers, temp, 0, numbers.size());
-        }
-    }
+/**
+ * @brief Generates a shuffled sequence with the cache-blocked Rao–Sandelius algorithm.
+ *
+ * One streaming pass sends the numbers 1 to length into random buckets that fit in the
+ * L2 cache, writing them through small per-bucket buffers straight into the result, and
+ * each bucket is then shuffled on its own while it is cache-resident. There is no
+ * separate fill pass and no full-size scratch buffer.
+ *
+ * @param length The number of elements to shuffle.
+ * @return A vector containing the numbers 1 to length in a pseudo-random order.
+ */
+Permutation NumbersShuffler::raoSandeliusShuffle(unsigned int length) {
+    Permutation numbers(length);
+    shuffle::PhaseScope scope(shuffle::Phase::Shuffle);
+
+    shuffle::raoSandeliusGenerate(numbers.begin(), numbers.end(), m_mtEngine, identityValue);
 
     return numbers;
 }
@@ -1,14 +1,45 @@
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include "shuffle/phase.hpp"
+#include "shuffle/thread_pool.hpp"
+#include "util/memory_usage.hpp"
 #include "util/statistics.hpp"
 
 
+namespace {
+
+// Upper bound on the memory taken by the per-batch frequency tables of a parallel run.
+const std::size_t kMaxParallelFrequencyBytes = std::size_t(1) << 30;
+
+// Adds the positions of `iterations` fresh shuffles to `frequencies`.
+void accumulateFrequencies(
+    NumbersShuffler& shuffler,
+    ShuffleFunc func,
+    unsigned int length,
+    unsigned int iterations,
+    std::vector<unsigned int>& frequencies
+) {
+    for (unsigned int iter = 0; iter < iterations; ++iter) {
+        Permutation perm = (shuffler.*func)(length);
+        shuffle::PhaseScope statsScope(shuffle::Phase::Stats);
+        for (unsigned int pos = 0; pos < length; ++pos) {
+            unsigned int number = perm[pos];
+            unsigned int index = pos * (length + 1) + number;
+            frequencies[index] += 1;
+        }
+    }
+}
+
+} // namespace
+
+
 /**
  * @brief Runs the given shuffle method many times and collects per-position frequency statistics.
  *
@@ -17,13 +48,16 @@
  * @param funcName The name of the function.
  * @param length The length of the permutation (i.e. numbers 1..length).
  * @param iterations How many shuffles to perform.
+ * @param pool If not null, the iterations are split into one batch per pool participant,
+ *        each counting into its own frequency table, and the tables are summed at the end.
  */
 void produceShuffleStats(
     NumbersShuffler& shuffler,
     ShuffleFunc func,
     const std::string& funcName,
     unsigned int length,
-    unsigned int iterations
+    unsigned int iterations,
+    shuffle::WorkStealingPool* pool
 ) {
     std::cout << "Testing " << funcName
               << " with permutation length = " << length
@@ -31,9 +65,11 @@ void produceShuffleStats(
 
     // For one iteration only time the shuffle and show a small sample.
     if (iterations <= 1) {
+        MemoryMonitor monitor;
         std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
-        std::vector<unsigned int> perm = (shuffler.*func)(length);
+        Permutation perm = (shuffler.*func)(length);
         std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+        MemoryUsage memory = monitor.stop();
         long long elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
 
         std::cout << "\nExecution Time for " << funcName << ": " 
@@ -43,7 +79,9 @@ void produceShuffleStats(
         for (unsigned int i = 0; i < sampleCount; ++i) {
             std::cout << perm[i] << " ";
         }
-        std::cout << "\n" << std::string(80, '=') << "\n\n";
+        std::cout << "\n";
+        printMemoryUsage(memory, 1);
+        std::cout << std::string(80, '=') << "\n\n";
         return;
     }
 
@@ -52,16 +90,48 @@ void produceShuffleStats(
     unsigned int frequencySize = length * (length + 1);
     std::vector<unsigned int> frequencies(frequencySize, 0);
 
+    // Per-batch tables of a parallel run are allocated up front, so that the memory
+    // report covers the shuffles alone.
+    std::vector<std::vector<unsigned int>> tables;
+    if (pool != nullptr) {
+        std::size_t tableBytes = static_cast<std::size_t>(frequencySize) * sizeof(unsigned int);
+        unsigned int batches = std::min(pool->workers() + 1, iterations);
+        batches = static_cast<unsigned int>(std::max<std::size_t>(1,
+            std::min<std::size_t>(batches, kMaxParallelFrequencyBytes / tableBytes)));
+        tables.assign(batches, std::vector<unsigned int>(frequencySize, 0));
+    }
+
+    MemoryMonitor monitor;
     std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
-    for (unsigned int iter = 0; iter < iterations; ++iter) {
-        std::vector<unsigned int> perm = (shuffler.*func)(length);
-        for (unsigned int pos = 0; pos < length; ++pos) {
-            unsigned int number = perm[pos];
-            unsigned int index = pos * (length + 1) + number;
-            frequencies[index] += 1;
+    if (pool == nullptr) {
+        accumulateFrequencies(shuffler, func, length, iterations, frequencies);
+    } else {
+        // A shuffler must not be shared between threads, so every batch gets its own fork.
+        unsigned int batches = static_cast<unsigned int>(tables.size());
+        std::vector<NumbersShuffler> batchShufflers;
+        for (unsigned int batch = 0; batch < batches; ++batch) {
+            batchShufflers.push_back(shuffler.fork());
+        }
+        {
+            shuffle::TaskGroup group(*pool);
+            for (unsigned int batch = 0; batch < batches; ++batch) {
+                unsigned int batchIterations = iterations / batches + (batch < iterations % batches ? 1 : 0);
+                group.run([&, batch, batchIterations] {
+                    accumulateFrequencies(batchShufflers[batch], func, length, batchIterations, tables[batch]);
+                });
+            }
+            group.wait();
+        }
+
+        shuffle::PhaseScope statsScope(shuffle::Phase::Stats);
+        for (const std::vector<unsigned int>& table : tables) {
+            for (unsigned int i = 0; i < frequencySize; ++i) {
+                frequencies[i] += table[i];
+            }
         }
     }
     std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+    MemoryUsage memory = monitor.stop();
     long long elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
 
     std::cout << "\nStatistics for " << funcName
@@ -208,5 +278,6 @@ void produceShuffleStats(
 
     std::cout << "\nExecution Time for " << funcName << ": "
               << elapsedTime << " ms\n";
+    printMemoryUsage(memory, iterations);
     std::cout << std::string(80, '=') << "\n\n";
 }
@@ -0,0 +1,112 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/stress.hpp"
+
+
+namespace {
+
+// Keeps the shuffles from being optimised away.
+std::atomic<std::uint64_t> g_sink{0};
+
+// Returns the wall-clock time of `threads` threads each making `iterations` calls.
+double timeConcurrentShuffles(
+    NumbersShuffler& shuffler,
+    ShuffleFunc func,
+    unsigned int length,
+    unsigned int iterations,
+    unsigned int threads
+) {
+    std::vector<NumbersShuffler> shufflers;
+    for (unsigned int t = 0; t < threads; t++) {
+        shufflers.push_back(shuffler.fork());
+    }
+
+    // Threads start together once all of them exist, so thread creation is not timed.
+    std::atomic<unsigned int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            std::uint64_t sink = 0;
+            for (unsigned int i = 0; i < iterations; i++) {
+                Permutation perm = (shufflers[t].*func)(length);
+                sink += perm[0];
+            }
+            g_sink.fetch_add(sink, std::memory_order_relaxed);
+        });
+    }
+
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    go.store(true);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+} // namespace
+
+
+std::vector<StressPoint> runStressBenchmark(
+    NumbersShuffler& shuffler,
+    ShuffleFunc func,
+    unsigned int length,
+    unsigned int iterations,
+    unsigned int maxThreads
+) {
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    std::vector<StressPoint> points;
+    for (unsigned int threads : threadCounts) {
+        StressPoint point;
+        point.threads = threads;
+        point.seconds = timeConcurrentShuffles(shuffler, func, length, iterations, threads);
+        point.shufflesPerSecond = static_cast<double>(threads) * iterations / point.seconds;
+        point.speedup = points.empty() ? 1.0 : point.shufflesPerSecond / points.front().shufflesPerSecond;
+        point.efficiency = point.speedup / threads;
+        points.push_back(point);
+    }
+    return points;
+}
+
+
+void printStressBenchmark(
+    const std::string& funcName,
+    unsigned int length,
+    unsigned int iterations,
+    const std::vector<StressPoint>& points
+) {
+    std::cout << "Stress testing " << funcName << " with permutation length = " << length
+              << " (" << iterations << " shuffles per thread, one shuffler per thread)\n\n";
+    std::cout << std::setw(10) << "Threads"
+              << std::setw(14) << "Time (s)"
+              << std::setw(18) << "Shuffles/s"
+              << std::setw(12) << "Speedup"
+              << std::setw(14) << "Efficiency" << "\n";
+    for (const StressPoint& point : points) {
+        std::cout << std::setw(10) << point.threads
+                  << std::setw(14) << std::fixed << std::setprecision(3) << point.seconds
+                  << std::setw(18) << std::setprecision(0) << point.shufflesPerSecond
+                  << std::setw(12) << std::setprecision(2) << point.speedup
+                  << std::setw(13) << std::setprecision(0) << 100.0 * point.efficiency << "%\n";
+    }
+    std::cout << std::string(80, '=') << "\n\n";
+}